@@ -0,0 +1,145 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hash_map.h"
+
+struct hash_map_entry {
+	struct hash_map_entry *next;
+	uint32_t hash;
+	void *value;
+	char key[];
+};
+
+uint32_t hash_string(const char *str) {
+	uint32_t hash = 2166136261u;
+	for (const unsigned char *p = (const unsigned char *)str; *p; ++p) {
+		hash ^= *p;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+hash_map_t *create_hash_map(void) {
+	hash_map_t *map = calloc(1, sizeof(hash_map_t));
+	if (!map) {
+		return NULL;
+	}
+	map->capacity = 16;
+	map->buckets = calloc(map->capacity, sizeof(*map->buckets));
+	if (!map->buckets) {
+		free(map);
+		return NULL;
+	}
+	return map;
+}
+
+void hash_map_free(hash_map_t *map) {
+	if (!map) {
+		return;
+	}
+	for (size_t i = 0; i < map->capacity; ++i) {
+		struct hash_map_entry *entry = map->buckets[i];
+		while (entry) {
+			struct hash_map_entry *next = entry->next;
+			free(entry);
+			entry = next;
+		}
+	}
+	free(map->buckets);
+	free(map);
+}
+
+static struct hash_map_entry **find_entry(hash_map_t *map,
+		const char *key, uint32_t hash) {
+	struct hash_map_entry **entry = &map->buckets[hash & (map->capacity - 1)];
+	for (; *entry; entry = &(*entry)->next) {
+		if ((*entry)->hash == hash && strcmp((*entry)->key, key) == 0) {
+			break;
+		}
+	}
+	return entry;
+}
+
+void *hash_map_get(hash_map_t *map, const char *key) {
+	struct hash_map_entry *entry = *find_entry(map, key, hash_string(key));
+	return entry ? entry->value : NULL;
+}
+
+const char *hash_map_get_key(hash_map_t *map, const char *key) {
+	struct hash_map_entry *entry = *find_entry(map, key, hash_string(key));
+	return entry ? entry->key : NULL;
+}
+
+static bool hash_map_resize(hash_map_t *map, size_t capacity) {
+	struct hash_map_entry **buckets = calloc(capacity, sizeof(*buckets));
+	if (!buckets) {
+		return false;
+	}
+	for (size_t i = 0; i < map->capacity; ++i) {
+		struct hash_map_entry *entry = map->buckets[i];
+		while (entry) {
+			struct hash_map_entry *next = entry->next;
+			size_t index = entry->hash & (capacity - 1);
+			entry->next = buckets[index];
+			buckets[index] = entry;
+			entry = next;
+		}
+	}
+	free(map->buckets);
+	map->buckets = buckets;
+	map->capacity = capacity;
+	return true;
+}
+
+bool hash_map_set(hash_map_t *map, const char *key, void *value) {
+	uint32_t hash = hash_string(key);
+	struct hash_map_entry **slot = find_entry(map, key, hash);
+	if (*slot) {
+		(*slot)->value = value;
+		return true;
+	}
+
+	// Keep the load factor below one. If growing fails the map still works,
+	// it just gets slower.
+	if (map->length >= map->capacity &&
+			hash_map_resize(map, map->capacity * 2)) {
+		slot = find_entry(map, key, hash);
+	}
+
+	size_t len = strlen(key) + 1;
+	struct hash_map_entry *entry = malloc(sizeof(*entry) + len);
+	if (!entry) {
+		return false;
+	}
+	entry->next = NULL;
+	entry->hash = hash;
+	entry->value = value;
+	memcpy(entry->key, key, len);
+	*slot = entry;
+	map->length++;
+	return true;
+}
+
+void *hash_map_remove(hash_map_t *map, const char *key) {
+	struct hash_map_entry **slot = find_entry(map, key, hash_string(key));
+	struct hash_map_entry *entry = *slot;
+	if (!entry) {
+		return NULL;
+	}
+	void *value = entry->value;
+	*slot = entry->next;
+	free(entry);
+	map->length--;
+	return value;
+}
+
+void hash_map_for_each(hash_map_t *map,
+		void (*callback)(const char *key, void *value, void *data), void *data) {
+	for (size_t i = 0; i < map->capacity; ++i) {
+		for (struct hash_map_entry *entry = map->buckets[i]; entry;
+				entry = entry->next) {
+			callback(entry->key, entry->value, data);
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#include <stdlib.h>
+#include "hash_map.h"
+#include "intern.h"
+#include "log.h"
+
+// The interned strings are the keys of the map, the values are unused
+static hash_map_t *interned;
+
+const char *intern_string(const char *str) {
+	if (!str) {
+		return NULL;
+	}
+
+	if (!interned) {
+		interned = create_hash_map();
+		if (!interned) {
+			sway_log(SWAY_ERROR, "Unable to allocate string intern table");
+			return NULL;
+		}
+	}
+
+	const char *canonical = hash_map_get_key(interned, str);
+	if (canonical) {
+		return canonical;
+	}
+
+	if (!hash_map_set(interned, str, NULL)) {
+		sway_log(SWAY_ERROR, "Unable to allocate interned string");
+		return NULL;
+	}
+	return hash_map_get_key(interned, str);
+}
@@ -1,9 +1,12 @@
 #define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 #include "ipc-client.h"
@@ -13,6 +16,17 @@ static const char ipc_magic[] = {'i', '3', '-', 'i', 'p', 'c'};
 
 #define IPC_HEADER_SIZE (sizeof(ipc_magic) + 8)
 
+struct ipc_connection {
+	int fd;
+	char *buf;
+	size_t size;
+	size_t start; // first byte not yet taken by ipc_connection_next
+	size_t end; // end of the received bytes, always < size
+	// end of the last payload taken, overwritten with a nul byte
+	char *terminator;
+	char terminated;
+};
+
 char *get_socketpath(void) {
 	const char *swaysock = getenv("SWAYSOCK");
 	if (swaysock) {
@@ -126,18 +140,43 @@ void free_ipc_response(struct ipc_response *response) {
 	free(response);
 }
 
-char *ipc_single_command(int socketfd, uint32_t type, const char *payload, uint32_t *len) {
+static bool ipc_write_message(int socketfd, uint32_t type, const char *payload,
+		uint32_t len) {
 	char data[IPC_HEADER_SIZE];
 	memcpy(data, ipc_magic, sizeof(ipc_magic));
-	memcpy(data + sizeof(ipc_magic), len, sizeof(*len));
-	memcpy(data + sizeof(ipc_magic) + sizeof(*len), &type, sizeof(type));
+	memcpy(data + sizeof(ipc_magic), &len, sizeof(len));
+	memcpy(data + sizeof(ipc_magic) + sizeof(len), &type, sizeof(type));
 
-	if (write(socketfd, data, IPC_HEADER_SIZE) == -1) {
-		sway_abort("Unable to send IPC header");
+	struct iovec iov[] = {
+		{ .iov_base = data, .iov_len = IPC_HEADER_SIZE },
+		{ .iov_base = (void *)payload, .iov_len = len },
+	};
+	struct iovec *vec = iov;
+	int count = len > 0 ? 2 : 1;
+	while (count > 0) {
+		ssize_t written = writev(socketfd, vec, count);
+		if (written == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		while (count > 0 && (size_t)written >= vec->iov_len) {
+			written -= vec->iov_len;
+			++vec;
+			--count;
+		}
+		if (count > 0) {
+			vec->iov_base = (char *)vec->iov_base + written;
+			vec->iov_len -= written;
+		}
 	}
+	return true;
+}
 
-	if (write(socketfd, payload, *len) == -1) {
-		sway_abort("Unable to send IPC payload");
+char *ipc_single_command(int socketfd, uint32_t type, const char *payload, uint32_t *len) {
+	if (!ipc_write_message(socketfd, type, payload, *len)) {
+		sway_abort("Unable to send IPC message");
 	}
 
 	struct ipc_response *resp = ipc_recv_response(socketfd);
@@ -147,3 +186,113 @@ char *ipc_single_command(int socketfd, uint32_t type, const char *payload, uint3
 
 	return response;
 }
+
+struct ipc_connection *ipc_connection_create(int socketfd) {
+	struct ipc_connection *conn = calloc(1, sizeof(struct ipc_connection));
+	if (!conn) {
+		return NULL;
+	}
+	conn->fd = socketfd;
+	return conn;
+}
+
+void ipc_connection_destroy(struct ipc_connection *conn) {
+	if (!conn) {
+		return;
+	}
+	free(conn->buf);
+	free(conn);
+}
+
+bool ipc_connection_send(struct ipc_connection *conn, uint32_t type,
+		const char *payload, uint32_t len) {
+	return ipc_write_message(conn->fd, type, payload, len);
+}
+
+static void restore_terminator(struct ipc_connection *conn) {
+	if (conn->terminator) {
+		*conn->terminator = conn->terminated;
+		conn->terminator = NULL;
+	}
+}
+
+bool ipc_connection_read(struct ipc_connection *conn) {
+	restore_terminator(conn);
+	if (conn->start > 0) {
+		conn->end -= conn->start;
+		memmove(conn->buf, conn->buf + conn->start, conn->end);
+		conn->start = 0;
+	}
+
+	while (true) {
+		// Keep a spare byte to terminate the last payload in place
+		if (conn->end + 1 >= conn->size) {
+			size_t size = conn->size ? conn->size * 2 : 4096;
+			char *buf = realloc(conn->buf, size);
+			if (!buf) {
+				sway_log(SWAY_ERROR, "Unable to allocate IPC buffer");
+				// Try again once the buffered messages have been handled
+				return true;
+			}
+			conn->buf = buf;
+			conn->size = size;
+		}
+		ssize_t received = recv(conn->fd, conn->buf + conn->end,
+				conn->size - conn->end - 1, MSG_DONTWAIT);
+		if (received > 0) {
+			conn->end += received;
+		} else if (received == 0) {
+			return false;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return true;
+		} else if (errno != EINTR) {
+			sway_log_errno(SWAY_ERROR, "Unable to receive IPC message");
+			return false;
+		}
+	}
+}
+
+bool ipc_connection_next(struct ipc_connection *conn, struct ipc_message *msg) {
+	restore_terminator(conn);
+	size_t available = conn->end - conn->start;
+	if (available < IPC_HEADER_SIZE) {
+		return false;
+	}
+	char *header = conn->buf + conn->start;
+	if (memcmp(header, ipc_magic, sizeof(ipc_magic)) != 0) {
+		sway_log(SWAY_ERROR, "Invalid IPC message header, dropping %zu bytes",
+				available);
+		conn->start = conn->end;
+		return false;
+	}
+	memcpy(&msg->size, header + sizeof(ipc_magic), sizeof(uint32_t));
+	memcpy(&msg->type, header + sizeof(ipc_magic) + sizeof(uint32_t),
+			sizeof(uint32_t));
+	if (available - IPC_HEADER_SIZE < msg->size) {
+		return false;
+	}
+
+	msg->payload = header + IPC_HEADER_SIZE;
+	conn->terminator = msg->payload + msg->size;
+	conn->terminated = *conn->terminator;
+	*conn->terminator = '\0';
+	conn->start += IPC_HEADER_SIZE + msg->size;
+	return true;
+}
+
+bool ipc_connection_recv(struct ipc_connection *conn, struct ipc_message *msg) {
+	while (!ipc_connection_next(conn, msg)) {
+		struct pollfd pfd = { .fd = conn->fd, .events = POLLIN };
+		if (poll(&pfd, 1, -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			sway_log_errno(SWAY_ERROR, "Unable to poll IPC socket");
+			return false;
+		}
+		if (!ipc_connection_read(conn)) {
+			return false;
+		}
+	}
+	return true;
+}
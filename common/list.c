@@ -76,6 +76,18 @@ int list_find(list_t *list, const void *item) {
 	return -1;
 }
 
+bool list_equal(list_t *a, list_t *b) {
+	if (a->length != b->length) {
+		return false;
+	}
+	for (int i = 0; i < a->length; i++) {
+		if (a->items[i] != b->items[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void list_swap(list_t *list, int src, int dest) {
 	void *tmp = list->items[src];
 	list->items[src] = list->items[dest];
@@ -105,6 +105,10 @@ void sway_log_init(sway_log_importance_t verbosity, terminate_callback_t callbac
 	}
 }
 
+sway_log_importance_t sway_log_get_verbosity(void) {
+	return log_importance;
+}
+
 void _sway_vlog(sway_log_importance_t verbosity, const char *fmt, va_list args) {
 	sway_log_stderr(verbosity, fmt, args);
 }
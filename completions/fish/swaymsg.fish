@@ -1,6 +1,7 @@
 # swaymsg(1) completion
 
 complete -f -c swaymsg
+complete -c swaymsg -s f -l filter -r --description "Only print the given comma separated fields of subscribed events."
 complete -c swaymsg -s h -l help --description "Show help message and quit."
 complete -c swaymsg -s m -l monitor --description "Monitor subscribed events until killed."
 complete -c swaymsg -s p -l pretty --description "Use pretty output even when not using a tty."
@@ -0,0 +1,39 @@
+#ifndef _SWAY_HASH_MAP_H
+#define _SWAY_HASH_MAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct hash_map_entry;
+
+/**
+ * A map from strings to pointers. Keys are copied into the map, values are
+ * owned by the caller.
+ */
+typedef struct {
+	struct hash_map_entry **buckets;
+	size_t capacity; // always a power of two
+	size_t length;
+} hash_map_t;
+
+hash_map_t *create_hash_map(void);
+/* Frees the map and its keys, but not the values. */
+void hash_map_free(hash_map_t *map);
+// Returns the value for key, or NULL if it isn't in the map.
+void *hash_map_get(hash_map_t *map, const char *key);
+// Returns the map's own copy of key, which lives as long as the entry, or NULL
+// if it isn't in the map.
+const char *hash_map_get_key(hash_map_t *map, const char *key);
+// Sets the value for key, replacing any previous value. Returns false if the
+// entry couldn't be allocated.
+bool hash_map_set(hash_map_t *map, const char *key, void *value);
+// Removes key from the map and returns its value, or NULL if it wasn't there.
+void *hash_map_remove(hash_map_t *map, const char *key);
+// Calls callback for every entry, in no particular order. The map must not be
+// modified by the callback.
+void hash_map_for_each(hash_map_t *map,
+		void (*callback)(const char *key, void *value, void *data), void *data);
+
+// FNV-1a hash of a nul-terminated string
+uint32_t hash_string(const char *str);
+#endif
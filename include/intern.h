@@ -0,0 +1,18 @@
+#ifndef _SWAY_INTERN_H
+#define _SWAY_INTERN_H
+
+/**
+ * Returns the canonical copy of the given string, adding it to the global
+ * intern table if it isn't there yet. Two interned strings are equal if and
+ * only if their pointers are equal, so they can be compared by identity
+ * instead of with strcmp.
+ *
+ * Interned strings live until the process exits and must not be freed or
+ * modified. Only use this for strings drawn from a small, bounded set, such
+ * as input device identifiers.
+ *
+ * Returns NULL if str is NULL or on allocation failure.
+ */
+const char *intern_string(const char *str);
+
+#endif
@@ -43,4 +43,51 @@ void free_ipc_response(struct ipc_response *response);
  */
 bool ipc_set_recv_timeout(int socketfd, struct timeval tv);
 
+/**
+ * A buffered reader and writer for an IPC socket, for clients which handle
+ * events or several replies without blocking or allocating per message.
+ * Requests can be sent while earlier replies are still outstanding; sway
+ * replies in order, interleaved with events.
+ */
+struct ipc_connection;
+
+/**
+ * A message received by an ipc_connection. The payload points into the
+ * connection's buffer and is nul-terminated until the next call to
+ * ipc_connection_next. Its bytes stay valid until the next call to
+ * ipc_connection_read or ipc_connection_recv.
+ */
+struct ipc_message {
+	uint32_t size;
+	uint32_t type;
+	char *payload;
+};
+
+/**
+ * Creates a connection for the connected socket. The socket stays owned by the
+ * caller and must outlive the connection.
+ */
+struct ipc_connection *ipc_connection_create(int socketfd);
+void ipc_connection_destroy(struct ipc_connection *conn);
+/**
+ * Sends a message with a single writev. Returns false on error.
+ */
+bool ipc_connection_send(struct ipc_connection *conn, uint32_t type,
+		const char *payload, uint32_t len);
+/**
+ * Reads everything available on the socket without blocking. Returns false
+ * if the connection was closed or failed.
+ */
+bool ipc_connection_read(struct ipc_connection *conn);
+/**
+ * Takes the next complete message from the buffer, without reading from the
+ * socket. Returns false if there is none.
+ */
+bool ipc_connection_next(struct ipc_connection *conn, struct ipc_message *msg);
+/**
+ * Blocks until a complete message is available and takes it. Returns false if
+ * the connection was closed or failed.
+ */
+bool ipc_connection_recv(struct ipc_connection *conn, struct ipc_message *msg);
+
 #endif
@@ -1,6 +1,8 @@
 #ifndef _SWAY_LIST_H
 #define _SWAY_LIST_H
 
+#include <stdbool.h>
+
 typedef struct {
 	int capacity;
 	int length;
@@ -20,6 +22,8 @@ void list_qsort(list_t *list, int compare(const void *left, const void *right));
 // function or -1 if none matches.
 int list_seq_find(list_t *list, int compare(const void *item, const void *cmp_to), const void *cmp_to);
 int list_find(list_t *list, const void *item);
+// Return true if both lists contain the same items in the same order.
+bool list_equal(list_t *a, list_t *b);
 // stable sort since qsort is not guaranteed to be stable
 void list_stable_sort(list_t *list, int compare(const void *a, const void *b));
 // swap two elements in a list
@@ -27,6 +27,9 @@ typedef void (*terminate_callback_t)(int exit_code);
 // Will log all messages less than or equal to `verbosity`
 // The `terminate` callback is called by `sway_abort`
 void sway_log_init(sway_log_importance_t verbosity, terminate_callback_t terminate);
+// Returns the verbosity passed to sway_log_init, to skip preparing messages
+// which would not be logged
+sway_log_importance_t sway_log_get_verbosity(void);
 
 void _sway_log(sway_log_importance_t verbosity, const char *format, ...) ATTRIB_PRINTF(2, 3);
 void _sway_vlog(sway_log_importance_t verbosity, const char *format, va_list args) ATTRIB_PRINTF(2, 0);
@@ -0,0 +1,21 @@
+#ifndef _SWAY_BENCH_H
+#define _SWAY_BENCH_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "sway/output.h"
+
+/**
+ * Starts sway on the headless backend with an empty config and adds a
+ * headless output of the given size. The event loop never runs, so the
+ * benchmarks drive the tree, transactions and rendering directly.
+ *
+ * Returns the output, or NULL on failure.
+ */
+struct sway_output *bench_init(int width, int height, bool verbose);
+
+void bench_fini(void);
+
+uint64_t bench_now_nsec(clockid_t clock);
+
+#endif
@@ -58,6 +58,27 @@ struct cmd_handler *find_handler(char *line, struct cmd_handler *cmd_handlers,
  */
 list_t *execute_command(char *command,  struct sway_seat *seat,
 		struct sway_container *con);
+
+struct cmd_list;
+
+/**
+ * Splits a command list and looks up its handlers and criteria ahead of time,
+ * so that it can be run repeatedly without being parsed again. Arguments that
+ * reference variables are still expanded every time the list runs.
+ *
+ * Returns NULL if the command list is invalid. Pass the string to
+ * execute_command in that case, which also reports the error.
+ */
+struct cmd_list *cmd_list_compile(const char *command);
+
+void cmd_list_destroy(struct cmd_list *list);
+
+/**
+ * Executes a command list compiled with cmd_list_compile. This behaves exactly
+ * like execute_command would with the command list's source string.
+ */
+list_t *execute_cmd_list(struct cmd_list *list, struct sway_seat *seat,
+		struct sway_container *con);
 /**
  * Parse and handles a command during config file loading.
  *
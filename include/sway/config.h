@@ -16,6 +16,9 @@
 
 // TODO: Refactor this shit
 
+struct cmd_list;
+struct sway_variable_node;
+
 /**
  * Describes a variable created via the `set` command.
  */
@@ -50,13 +53,14 @@ enum binding_flags {
 struct sway_binding {
 	enum binding_input_type type;
 	int order;
-	char *input;
+	const char *input; // interned, see intern.h
 	uint32_t flags;
 	list_t *keys; // sorted in ascending order
 	list_t *syms; // sorted in ascending order; NULL if BINDING_CODE is not set
 	uint32_t modifiers;
 	xkb_layout_index_t group;
 	char *command;
+	struct cmd_list *compiled_command; // NULL if command failed to compile
 };
 
 /**
@@ -120,7 +124,7 @@ enum input_config_mapped_to {
  * options for input devices
  */
 struct input_config {
-	char *identifier;
+	const char *identifier; // interned, see intern.h
 	const char *input_type;
 
 	int accel_profile;
@@ -168,7 +172,7 @@ struct input_config {
  * Options for misc device configurations that happen in the seat block
  */
 struct seat_attachment_config {
-	char *identifier;
+	const char *identifier; // interned, see intern.h
 	// TODO other things are configured here for some reason
 };
 
@@ -432,13 +436,35 @@ enum xwayland_mode {
 	XWAYLAND_MODE_IMMEDIATE,
 };
 
+enum config_profile_kind {
+	CONFIG_PROFILE_FILE,
+	CONFIG_PROFILE_HANDLER,
+	CONFIG_PROFILE_PHASE,
+};
+
+struct config_profile_entry {
+	char *name;
+	int count;
+	uint64_t nsec;
+};
+
+/**
+ * Time spent loading the config, collected with `-D profile-config`.
+ */
+struct config_profile {
+	list_t *files; // struct config_profile_entry
+	list_t *handlers; // struct config_profile_entry
+	list_t *phases; // struct config_profile_entry
+};
+
 /**
  * The configuration struct. The result of loading a config file.
  */
 struct sway_config {
 	char *swaynag_command;
 	struct swaynag_instance swaynag_config_errors;
-	list_t *symbols;
+	list_t *symbols; // struct sway_variable, in definition order
+	struct sway_variable_node *symbol_tree; // prefix tree over symbol names
 	list_t *modes;
 	list_t *bars;
 	list_t *cmd_queue;
@@ -533,6 +559,9 @@ struct sway_config {
 	// The keysym to keycode translation
 	struct xkb_state *keysym_translation_state;
 
+	// NULL unless the profile-config debug flag is set
+	struct config_profile *profile;
+
 	// Context for command handlers
 	struct {
 		struct input_config *input_config;
@@ -590,11 +619,25 @@ void free_config(struct sway_config *config);
 
 void free_sway_variable(struct sway_variable *var);
 
+/**
+ * Returns the variable with the given name (including the leading $), or NULL.
+ */
+struct sway_variable *find_sway_variable(const char *name);
+
+/**
+ * Adds a new variable to the config. The config takes ownership of it.
+ */
+bool store_sway_variable(struct sway_variable *var);
+
 /**
  * Does variable replacement for a string based on the config's currently loaded variables.
  */
 char *do_var_replacement(char *str);
 
+/**
+ * Compares an input config against an identifier for list_seq_find. The
+ * identifier must be interned.
+ */
 int input_identifier_cmp(const void *item, const void *data);
 
 struct input_config *new_input_config(const char* identifier);
@@ -608,6 +651,13 @@ void input_config_fill_rule_names(struct input_config *ic,
 
 void free_input_config(struct input_config *ic);
 
+/**
+ * Returns true if the input configs of the current config differ from the ones
+ * in old_config. Configs using xkb_file always count as changed, since the
+ * file contents may have been edited.
+ */
+bool input_configs_changed(struct sway_config *old_config);
+
 int seat_name_cmp(const void *item, const void *data);
 
 struct seat_config *new_seat_config(const char* name);
@@ -621,10 +671,16 @@ void free_seat_config(struct seat_config *ic);
 struct seat_attachment_config *seat_attachment_config_new(void);
 
 struct seat_attachment_config *seat_config_get_attachment(
-		struct seat_config *seat_config, char *identifier);
+		struct seat_config *seat_config, const char *identifier);
 
 struct seat_config *store_seat_config(struct seat_config *seat);
 
+/**
+ * Returns true if the seat configs of the current config differ from the ones
+ * in old_config.
+ */
+bool seat_configs_changed(struct sway_config *old_config);
+
 int output_name_cmp(const void *item, const void *data);
 
 void output_get_identifier(char *identifier, size_t len,
@@ -648,6 +704,12 @@ void apply_output_config_to_outputs(struct output_config *oc);
 
 void reset_outputs(void);
 
+/**
+ * Returns true if the output configs of the current config differ from the
+ * ones in old_config.
+ */
+bool output_configs_changed(struct sway_config *old_config);
+
 void free_output_config(struct output_config *oc);
 
 bool spawn_swaybg(void);
@@ -690,6 +752,23 @@ bool translate_binding(struct sway_binding *binding);
 
 void translate_keysyms(struct input_config *input_config);
 
+struct config_profile *config_profile_create(void);
+
+void config_profile_destroy(struct config_profile *profile);
+
+/**
+ * Returns the current monotonic time in nanoseconds.
+ */
+uint64_t config_profile_now(void);
+
+/**
+ * Adds nsec to the named entry of the profile. Does nothing if profile is NULL.
+ */
+void config_profile_add(struct config_profile *profile,
+		enum config_profile_kind kind, const char *name, uint64_t nsec);
+
+void config_profile_log(struct config_profile *profile);
+
 void binding_add_translated(struct sway_binding *binding, list_t *bindings);
 
 /* Global config singleton. */
@@ -6,6 +6,8 @@
 #include "list.h"
 #include "tree/view.h"
 
+struct cmd_list;
+
 enum criteria_type {
 	CT_COMMAND                 = 1 << 0,
 	CT_ASSIGN_OUTPUT           = 1 << 1,
@@ -28,6 +30,7 @@ struct criteria {
 	enum criteria_type type;
 	char *raw; // entire criteria string (for logging)
 	char *cmdlist;
+	struct cmd_list *compiled_cmdlist; // NULL if cmdlist failed to compile
 	char *target; // workspace or output name for `assign` criteria
 
 	struct pattern *title;
@@ -35,6 +38,7 @@ struct criteria {
 	struct pattern *app_id;
 	struct pattern *con_mark;
 	uint32_t con_id; // internal ID
+	bool con_id_focused; // con_id=__focused__, resolved when matching
 #if HAVE_XWAYLAND
 	struct pattern *class;
 	uint32_t id; // X11 window ID
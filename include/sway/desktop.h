@@ -8,6 +8,8 @@ void desktop_damage_surface(struct wlr_surface *surface, double lx, double ly,
 
 void desktop_damage_whole_container(struct sway_container *con);
 
+void desktop_damage_container_decorations(struct sway_container *con);
+
 void desktop_damage_box(struct wlr_box *box);
 
 void desktop_damage_view(struct sway_view *view);
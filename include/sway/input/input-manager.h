@@ -10,7 +10,7 @@
 #include "list.h"
 
 struct sway_input_device {
-	char *identifier;
+	const char *identifier; // interned, see intern.h
 	struct wlr_input_device *wlr_device;
 	struct wl_list link;
 	struct wl_listener device_destroy;
@@ -69,7 +69,11 @@ struct sway_seat *input_manager_current_seat(void);
 
 struct input_config *input_device_get_config(struct sway_input_device *device);
 
-char *input_device_get_identifier(struct wlr_input_device *device);
+/**
+ * Returns the interned identifier for the given device. The result is owned by
+ * the intern table and must not be freed.
+ */
+const char *input_device_get_identifier(struct wlr_input_device *device);
 
 const char *input_device_get_type(struct sway_input_device *device);
 
@@ -47,6 +47,10 @@ struct sway_seat_node {
 	struct sway_node *node;
 
 	struct wl_list link; // sway_seat::focus_stack
+	struct wl_list node_link; // sway_node::seat_nodes
+
+	// Position in the focus stack; higher values are more recently focused
+	int64_t focus_seq;
 
 	struct wl_listener destroy;
 };
@@ -76,6 +80,7 @@ struct sway_seat {
 
 	bool has_focus;
 	struct wl_list focus_stack; // list of containers in focus order
+	int64_t focus_seq_top, focus_seq_bottom; // see sway_seat_node::focus_seq
 	struct sway_workspace *workspace;
 	char *prev_workspace_name; // for workspace back_and_forth
 
@@ -10,9 +10,12 @@ json_object *ipc_json_get_binding_mode(void);
 
 json_object *ipc_json_describe_disabled_output(struct sway_output *o);
 json_object *ipc_json_describe_node(struct sway_node *node);
+// Like ipc_json_describe_node, but without the floating_nodes of workspaces
+json_object *ipc_json_describe_node_shallow(struct sway_node *node);
 json_object *ipc_json_describe_node_recursive(struct sway_node *node);
 json_object *ipc_json_describe_input(struct sway_input_device *device);
 json_object *ipc_json_describe_seat(struct sway_seat *seat);
 json_object *ipc_json_describe_bar_config(struct bar_config *bar);
+json_object *ipc_json_describe_config_profile(struct config_profile *profile);
 
 #endif
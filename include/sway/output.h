@@ -56,6 +56,15 @@ struct sway_output {
 	uint32_t refresh_nsec;
 	int max_render_time; // In milliseconds
 	struct wl_event_source *repaint_timer;
+
+	// Counters for -D render-stats, logged and reset periodically
+	struct {
+		struct timespec since;
+		uint64_t frames;
+		uint64_t render_nsec;
+		uint64_t draws;
+		uint64_t texture_uploads;
+	} render_stats;
 };
 
 struct sway_output *output_create(struct wlr_output *wlr_output);
@@ -89,6 +98,14 @@ void output_damage_box(struct sway_output *output, struct wlr_box *box);
 void output_damage_whole_container(struct sway_output *output,
 	struct sway_container *con);
 
+/**
+ * Damage only the titlebar, borders and tab or stack header of the container
+ * and the decorations of its descendants. Use this when the contents of the
+ * views can't have changed, such as on focus and title changes.
+ */
+void output_damage_container_decorations(struct sway_output *output,
+	struct sway_container *con);
+
 // this ONLY includes the enabled outputs
 struct sway_output *output_by_name_or_id(const char *name_or_id);
 
@@ -96,6 +96,9 @@ struct sway_debug {
 	bool noatomic;         // Ignore atomic layout updates
 	bool txn_timings;      // Log verbose messages about transactions
 	bool txn_wait;         // Always wait for the timeout before applying
+	bool txn_partial;      // Apply transactions per output as views become ready
+	bool profile_config;   // Collect and log config loading times
+	bool render_stats;     // Log per-output render times and draw counts
 
 	enum {
 		DAMAGE_DEFAULT,    // Default behaviour
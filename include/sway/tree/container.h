@@ -97,6 +97,10 @@ struct sway_container {
 	double child_total_width;
 	double child_total_height;
 
+	// Whether any ancestor is a tabbed or stacked container, in which case
+	// there are no inner gaps. Cached by arrange.
+	bool in_tabbed_stacked;
+
 	// These are in layout coordinates.
 	double content_x, content_y;
 	int content_width, content_height;
@@ -301,6 +305,14 @@ struct sway_output *container_get_effective_output(struct sway_container *con);
 
 void container_discover_outputs(struct sway_container *con);
 
+/**
+ * Return true if the container's pending state may differ from what was last
+ * sent in a transaction. If the container is still referenced by a queued
+ * transaction its current state is not the latest one, so assume it changed.
+ * Focus is not considered; the seat marks nodes dirty when it changes.
+ */
+bool container_state_changed(struct sway_container *con);
+
 enum sway_container_layout container_parent_layout(struct sway_container *con);
 
 enum sway_container_layout container_current_parent_layout(
@@ -43,6 +43,8 @@ struct sway_node {
 	// the current.
 	bool dirty;
 
+	struct wl_list seat_nodes; // sway_seat_node::node_link
+
 	struct {
 		struct wl_signal destroy;
 	} events;
@@ -7,6 +7,7 @@
 #include "sway/tree/container.h"
 #include "sway/tree/node.h"
 #include "config.h"
+#include "hash_map.h"
 #include "list.h"
 
 extern struct sway_root *root;
@@ -30,6 +31,9 @@ struct sway_root {
 	list_t *outputs; // struct sway_output
 	list_t *scratchpad; // struct sway_container
 
+	// Marks are unique, this maps each mark to the container that has it
+	hash_map_t *marks; // struct sway_container
+
 	// For when there's no connected outputs
 	struct sway_output *noop_output;
 
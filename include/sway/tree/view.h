@@ -97,6 +97,14 @@ struct sway_view {
 	// when a transaction is applied.
 	struct wlr_box saved_geometry;
 
+	// How quickly the client acks the configures sent by transactions
+	struct {
+		uint32_t acks;
+		uint32_t timeouts;
+		float total_ms;
+		float max_ms;
+	} configure_stats;
+
 	struct wlr_foreign_toplevel_handle_v1 *foreign_toplevel;
 	struct wl_listener foreign_activate_request;
 	struct wl_listener foreign_fullscreen_request;
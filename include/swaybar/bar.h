@@ -15,6 +15,7 @@ struct swaybar_tray;
 #endif
 struct swaybar_workspace;
 struct loop;
+struct ipc_connection;
 
 struct swaybar {
 	char *id;
@@ -40,6 +41,7 @@ struct swaybar {
 
 	int ipc_event_socketfd;
 	int ipc_socketfd;
+	struct ipc_connection *ipc_events; // reads ipc_event_socketfd
 
 	struct wl_list outputs; // swaybar_output::link
 	struct wl_list unused_outputs; // swaybar_output::link
@@ -84,6 +86,7 @@ struct swaybar_output {
 
 struct swaybar_workspace {
 	struct wl_list link; // swaybar_output::workspaces
+	int id;
 	int num;
 	char *name;
 	char *label;
@@ -111,6 +114,7 @@ void set_bar_dirty(struct swaybar *bar);
  * Returns true if the bar is now visible, otherwise false.
  */
 bool determine_bar_visibility(struct swaybar *bar, bool moving_layer);
+void free_workspace(struct swaybar_workspace *ws);
 void free_workspaces(struct wl_list *list);
 
 void status_in(int fd, short mask, void *data);
@@ -6,6 +6,7 @@
 bool ipc_initialize(struct swaybar *bar);
 bool handle_ipc_readable(struct swaybar *bar);
 bool ipc_get_workspaces(struct swaybar *bar);
+void ipc_get_keyboard_layout(struct swaybar *bar);
 void ipc_send_workspace_command(struct swaybar *bar, const char *ws);
 void ipc_execute_binding(struct swaybar *bar, struct swaybar_binding *bind);
 
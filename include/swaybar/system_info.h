@@ -14,5 +14,11 @@ struct keyboard_layout_provider_t* create_keyboard_layout_provider();
 void destroy_keyboard_layout_provider(struct keyboard_layout_provider_t *klp);
 const char* get_current_keyboard_layout(struct keyboard_layout_provider_t *klp);
 
+// Feed the keyboard layout provider, if there is one, with the payloads of
+// input events and of the GET_INPUTS reply received by swaybar.
+// Returns 1 if the layout changed.
+int keyboard_layout_handle_input_event(const char *payload);
+void keyboard_layout_handle_get_inputs(const char *payload);
+
 #endif
 
@@ -1,6 +1,7 @@
 #ifndef _SWAYBAR_TRAY_ICON_H
 #define _SWAYBAR_TRAY_ICON_H
 
+#include "hash_map.h"
 #include "list.h"
 
 struct icon_theme_subdir {
@@ -26,6 +27,8 @@ struct icon_theme {
 
 	char *dir;
 	list_t *subdirs; // struct icon_theme_subdir *
+	// Icons of the theme, built on the first lookup in each basedir
+	hash_map_t *indexes; // basedir -> struct icon_theme_index *
 };
 
 void init_themes(list_t **themes, list_t **basedirs);
@@ -0,0 +1,35 @@
+#ifndef _SWAYBAR_TRAY_ICON_LOADER_H
+#define _SWAYBAR_TRAY_ICON_LOADER_H
+
+#include <cairo.h>
+#include <stdbool.h>
+
+/**
+ * Decodes icon files on a worker thread, so that rasterizing large SVGs
+ * doesn't block the bar's event loop. Loaded icons are handed back on the
+ * event loop once fd becomes readable, see icon_loader_in.
+ */
+struct swaybar_icon_loader;
+
+typedef void (*icon_loaded_func_t)(const char *path, cairo_surface_t *icon,
+		void *data);
+
+/**
+ * Creates a loader which calls handler for each loaded icon. icon is NULL if
+ * the file couldn't be loaded, and handler must take a reference to keep it.
+ * Returns NULL if the worker thread couldn't be started.
+ */
+struct swaybar_icon_loader *create_icon_loader(icon_loaded_func_t handler,
+		void *data);
+void destroy_icon_loader(struct swaybar_icon_loader *loader);
+int icon_loader_get_fd(struct swaybar_icon_loader *loader);
+
+/**
+ * Queues path for loading. Paths which are already queued or being loaded are
+ * only loaded once. Returns false if the request couldn't be queued.
+ */
+bool icon_loader_request(struct swaybar_icon_loader *loader, const char *path);
+
+void icon_loader_in(int fd, short mask, void *data);
+
+#endif
@@ -4,6 +4,7 @@
 #include <cairo.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
 #include "swaybar/tray/tray.h"
 #include "list.h"
 
@@ -14,6 +15,13 @@ struct swaybar_pixmap {
 	unsigned char pixels[];
 };
 
+// sni->icon scaled for one target size, see render_sni
+struct swaybar_sni_scaled_icon {
+	int target_size;
+	int icon_size;
+	cairo_surface_t *surface;
+};
+
 struct swaybar_sni_slot {
 	struct wl_list link; // swaybar_sni::slots
 	struct swaybar_sni *sni;
@@ -27,9 +35,13 @@ struct swaybar_sni {
 	// icon properties
 	struct swaybar_tray *tray;
 	cairo_surface_t *icon;
+	char *icon_path; // file icon was loaded from, NULL for pixmaps
+	char *pending_icon_path; // file which is being loaded to replace icon
+	struct timespec icon_mtime, pending_icon_mtime;
 	int min_size;
 	int max_size;
 	int target_size;
+	list_t *scaled_icons; // struct swaybar_sni_scaled_icon *
 
 	// dbus properties
 	char *watcher_id;
@@ -51,6 +63,12 @@ struct swaybar_sni {
 
 struct swaybar_sni *create_sni(char *id, struct swaybar_tray *tray);
 void destroy_sni(struct swaybar_sni *sni);
+/**
+ * Called when the icon at path has been loaded. Returns whether sni was
+ * waiting for it.
+ */
+bool sni_icon_loaded(struct swaybar_sni *sni, const char *path,
+		cairo_surface_t *icon);
 uint32_t render_sni(cairo_t *cairo, struct swaybar_output *output, double *x,
 		struct swaybar_sni *sni);
 
@@ -15,6 +15,7 @@
 struct swaybar;
 struct swaybar_output;
 struct swaybar_watcher;
+struct swaybar_icon_loader;
 
 struct swaybar_tray {
 	struct swaybar *bar;
@@ -30,11 +31,15 @@ struct swaybar_tray {
 
 	list_t *basedirs; // char *
 	list_t *themes; // struct swaybar_theme *
+	struct swaybar_icon_loader *icon_loader; // may be NULL
 };
 
 struct swaybar_tray *create_tray(struct swaybar *bar);
 void destroy_tray(struct swaybar_tray *tray);
 void tray_in(int fd, short mask, void *data);
+// Adds the tray's file descriptors to the bar's event loop, or removes them
+void tray_add_fds(struct swaybar_tray *tray);
+void tray_remove_fds(struct swaybar_tray *tray);
 uint32_t render_tray(cairo_t *cairo, struct swaybar_output *output, double *x);
 
 #endif
@@ -0,0 +1,85 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pango/pangocairo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <wlr/backend/headless.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/util/log.h>
+#include "sway/bench.h"
+#include "sway/config.h"
+#include "sway/desktop/transaction.h"
+#include "sway/ipc-server.h"
+#include "sway/server.h"
+#include "sway/tree/root.h"
+#include "log.h"
+
+// These are defined by main.c, which isn't linked into the benchmarks
+struct sway_server server = {0};
+struct sway_debug debug = {0};
+
+void sway_terminate(int exit_code) {
+	exit(exit_code);
+}
+
+struct sway_output *bench_init(int width, int height, bool verbose) {
+	if (!getenv("XDG_RUNTIME_DIR")) {
+		fprintf(stderr,
+				"XDG_RUNTIME_DIR is not set in the environment. Aborting.\n");
+		return NULL;
+	}
+
+	if (verbose) {
+		sway_log_init(SWAY_DEBUG, sway_terminate);
+		wlr_log_init(WLR_DEBUG, NULL);
+	} else {
+		sway_log_init(SWAY_ERROR, sway_terminate);
+		wlr_log_init(WLR_ERROR, NULL);
+	}
+
+	// The benchmark adds its own output
+	setenv("WLR_BACKENDS", "headless", true);
+	setenv("WLR_HEADLESS_OUTPUTS", "0", true);
+	setenv("WLR_LIBINPUT_NO_DEVICES", "1", true);
+
+	if (!server_privileged_prepare(&server)) {
+		return NULL;
+	}
+	root = root_create();
+	if (!server_init(&server)) {
+		return NULL;
+	}
+	ipc_init(&server);
+
+	if (!load_main_config("/dev/null", false, false)) {
+		return NULL;
+	}
+	config->xwayland = XWAYLAND_MODE_DISABLED;
+	if (!server_start(&server)) {
+		return NULL;
+	}
+	config->active = true;
+
+	struct wlr_output *wlr_output =
+		wlr_headless_add_output(server.headless_backend, width, height);
+	struct sway_output *output = wlr_output ? wlr_output->data : NULL;
+	if (!output || !output->enabled) {
+		sway_log(SWAY_ERROR, "Unable to create headless output");
+		return NULL;
+	}
+	transaction_commit_dirty();
+	return output;
+}
+
+void bench_fini(void) {
+	server_fini(&server);
+	root_destroy(root);
+	root = NULL;
+	free_config(config);
+	pango_cairo_font_map_set_default(NULL);
+}
+
+uint64_t bench_now_nsec(clockid_t clock) {
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
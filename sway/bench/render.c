@@ -0,0 +1,271 @@
+#define _POSIX_C_SOURCE 200809L
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wlr/types/wlr_output.h>
+#include "sway/bench.h"
+#include "sway/config.h"
+#include "sway/desktop/transaction.h"
+#include "sway/input/input-manager.h"
+#include "sway/input/seat.h"
+#include "sway/output.h"
+#include "sway/tree/arrange.h"
+#include "sway/tree/container.h"
+#include "sway/tree/workspace.h"
+#include "list.h"
+#include "log.h"
+
+/*
+ * Renders a synthetic tree on a headless output and reports the cost of
+ * output_render per frame. The tree has tiled, tabbed, stacked and floating
+ * containers with titles and marks. Its leaves have no views, since views
+ * need client surfaces, so the frames measure sway's own drawing: title bars,
+ * marks, borders and the background.
+ */
+
+enum damage_pattern {
+	DAMAGE_FULL,      // the whole output every frame
+	DAMAGE_CONTAINER, // one leaf container per frame, cycling
+	DAMAGE_MARKS,     // update one leaf's marks and damage its parent
+	DAMAGE_NONE,      // no damage, only the fixed cost of a frame
+};
+
+static const char *damage_pattern_names[] = {
+	[DAMAGE_FULL] = "full",
+	[DAMAGE_CONTAINER] = "container",
+	[DAMAGE_MARKS] = "marks",
+	[DAMAGE_NONE] = "none",
+};
+
+static bool parse_damage_pattern(const char *name,
+		enum damage_pattern *pattern) {
+	size_t len = sizeof(damage_pattern_names) / sizeof(damage_pattern_names[0]);
+	for (size_t i = 0; i < len; ++i) {
+		if (strcmp(name, damage_pattern_names[i]) == 0) {
+			*pattern = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static struct sway_container *add_leaf(struct sway_container *parent,
+		list_t *leaves) {
+	struct sway_container *con = container_create(NULL);
+	container_add_child(parent, con);
+
+	int n = leaves->length;
+	char buf[32];
+	snprintf(buf, sizeof(buf), "Container %d", n);
+	free(con->formatted_title);
+	con->formatted_title = strdup(buf);
+	container_calculate_title_height(con);
+	snprintf(buf, sizeof(buf), "mark%d", n);
+	container_add_mark(con, buf);
+
+	list_add(leaves, con);
+	return con;
+}
+
+static struct sway_container *add_split(struct sway_workspace *ws,
+		enum sway_container_layout layout, int children, list_t *leaves) {
+	struct sway_container *con = container_create(NULL);
+	con->layout = layout;
+	workspace_add_tiling(ws, con);
+	for (int i = 0; i < children; ++i) {
+		add_leaf(con, leaves);
+	}
+	return con;
+}
+
+static void add_floating(struct sway_workspace *ws, int index, list_t *leaves) {
+	struct sway_container *con = container_create(NULL);
+	con->layout = index % 2 ? L_TABBED : L_STACKED;
+	workspace_add_floating(ws, con);
+	add_leaf(con, leaves);
+	add_leaf(con, leaves);
+	container_floating_set_default_size(con);
+	con->x = ws->x + 32 * (index + 1);
+	con->y = ws->y + 32 * (index + 1);
+}
+
+static void build_tree(struct sway_workspace *ws, int count, list_t *leaves) {
+	add_split(ws, L_VERT, count, leaves);
+	struct sway_container *tabbed = add_split(ws, L_TABBED, count, leaves);
+	add_split(ws, L_STACKED, count, leaves);
+	for (int i = 0; i < count; ++i) {
+		add_floating(ws, i, leaves);
+	}
+
+	struct sway_seat *seat = input_manager_get_default_seat();
+	seat_set_focus_container(seat, tabbed->children->items[0]);
+
+	// Applying the transaction assigns the containers to the output, which
+	// renders their title and mark textures
+	arrange_root();
+	transaction_commit_dirty();
+}
+
+static void damage_container(struct sway_output *output,
+		pixman_region32_t *damage, struct sway_container *con) {
+	struct wlr_box box = {
+		.x = con->current.x - output->lx,
+		.y = con->current.y - output->ly,
+		.width = con->current.width,
+		.height = con->current.height,
+	};
+	scale_box(&box, output->wlr_output->scale);
+	pixman_region32_union_rect(damage, damage,
+			box.x, box.y, box.width, box.height);
+}
+
+static void frame_damage(struct sway_output *output, enum damage_pattern pattern,
+		list_t *leaves, int frame, pixman_region32_t *damage) {
+	struct sway_container *con = leaves->items[frame % leaves->length];
+	switch (pattern) {
+	case DAMAGE_FULL:
+		pixman_region32_union_rect(damage, damage, 0, 0,
+				output->width, output->height);
+		break;
+	case DAMAGE_CONTAINER:
+		damage_container(output, damage, con);
+		break;
+	case DAMAGE_MARKS:
+		container_update_marks_textures(con);
+		damage_container(output, damage, con->parent);
+		break;
+	case DAMAGE_NONE:
+		break;
+	}
+}
+
+static bool run(struct sway_output *output, enum damage_pattern pattern,
+		list_t *leaves, int frames) {
+	struct wlr_output *wlr_output = output->wlr_output;
+	memset(&output->render_stats, 0, sizeof(output->render_stats));
+
+	uint64_t cpu_nsec = 0, wall_nsec = 0;
+	uint64_t max_cpu_nsec = 0;
+	for (int i = 0; i < frames; ++i) {
+		// There is no event loop to deliver frame events, render right away
+		wlr_output->frame_pending = false;
+
+		uint64_t cpu_start = bench_now_nsec(CLOCK_PROCESS_CPUTIME_ID);
+		uint64_t wall_start = bench_now_nsec(CLOCK_MONOTONIC);
+
+		if (!wlr_output_attach_render(wlr_output, NULL)) {
+			sway_log(SWAY_ERROR, "Unable to attach renderer to output");
+			return false;
+		}
+		pixman_region32_t damage;
+		pixman_region32_init(&damage);
+		frame_damage(output, pattern, leaves, i, &damage);
+		struct timespec when;
+		clock_gettime(CLOCK_MONOTONIC, &when);
+		output_render(output, &when, &damage);
+		pixman_region32_fini(&damage);
+
+		uint64_t cpu = bench_now_nsec(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+		wall_nsec += bench_now_nsec(CLOCK_MONOTONIC) - wall_start;
+		cpu_nsec += cpu;
+		if (cpu > max_cpu_nsec) {
+			max_cpu_nsec = cpu;
+		}
+	}
+
+	printf("damage: %s\n", damage_pattern_names[pattern]);
+	printf("containers: %d leaves\n", leaves->length);
+	printf("frames: %d\n", frames);
+	printf("cpu time per frame: %.3fms (max %.3fms)\n",
+			cpu_nsec / 1000000.0 / frames, max_cpu_nsec / 1000000.0);
+	printf("wall time per frame: %.3fms\n", wall_nsec / 1000000.0 / frames);
+	printf("draw calls per frame: %.1f\n",
+			(double)output->render_stats.draws / frames);
+	printf("texture uploads per frame: %.2f\n",
+			(double)output->render_stats.texture_uploads / frames);
+	return true;
+}
+
+int main(int argc, char **argv) {
+	static struct option long_options[] = {
+		{"help", no_argument, NULL, 'h'},
+		{"containers", required_argument, NULL, 'n'},
+		{"frames", required_argument, NULL, 'f'},
+		{"damage", required_argument, NULL, 'D'},
+		{"size", required_argument, NULL, 's'},
+		{"debug", no_argument, NULL, 'd'},
+		{0, 0, 0, 0}
+	};
+
+	const char *usage =
+		"Usage: sway-render-bench [options]\n"
+		"\n"
+		"  -h, --help              Show help message and quit.\n"
+		"  -n, --containers <n>    Children per tiled, tabbed and stacked\n"
+		"                          container, and number of floating\n"
+		"                          containers. Defaults to 8.\n"
+		"  -f, --frames <n>        Number of frames to render. Defaults to 1000.\n"
+		"  -D, --damage <pattern>  full, container, marks or none.\n"
+		"                          Defaults to full.\n"
+		"  -s, --size <w>x<h>      Size of the output. Defaults to 1920x1080.\n"
+		"  -d, --debug             Enables full logging.\n"
+		"\n";
+
+	int count = 8, frames = 1000;
+	int width = 1920, height = 1080;
+	enum damage_pattern pattern = DAMAGE_FULL;
+	bool verbose = false;
+
+	int c;
+	while ((c = getopt_long(argc, argv, "hn:f:D:s:d", long_options, NULL)) != -1) {
+		switch (c) {
+		case 'h':
+			fprintf(stdout, "%s", usage);
+			exit(EXIT_SUCCESS);
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'f':
+			frames = atoi(optarg);
+			break;
+		case 'D':
+			if (!parse_damage_pattern(optarg, &pattern)) {
+				fprintf(stderr, "Unknown damage pattern: %s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 's':
+			if (sscanf(optarg, "%dx%d", &width, &height) != 2) {
+				fprintf(stderr, "Invalid size: %s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'd':
+			verbose = true;
+			break;
+		default:
+			fprintf(stderr, "%s", usage);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (count < 1 || frames < 1 || width < 1 || height < 1) {
+		fprintf(stderr, "%s", usage);
+		exit(EXIT_FAILURE);
+	}
+
+	struct sway_output *output = bench_init(width, height, verbose);
+	if (!output) {
+		return 1;
+	}
+
+	list_t *leaves = create_list();
+	build_tree(output_get_active_workspace(output), count, leaves);
+	bool ok = run(output, pattern, leaves, frames);
+	list_free(leaves);
+
+	bench_fini();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#define _POSIX_C_SOURCE 200809L
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sway/bench.h"
+#include "sway/desktop/transaction.h"
+#include "sway/input/input-manager.h"
+#include "sway/input/seat.h"
+#include "sway/output.h"
+#include "sway/server.h"
+#include "sway/tree/arrange.h"
+#include "sway/tree/container.h"
+#include "sway/tree/workspace.h"
+#include "list.h"
+
+/*
+ * Measures transaction_commit_dirty against the number of windows. The
+ * windows are spread over a fixed number of columns on one workspace. Every
+ * commit follows a focus change and a change of the workspace layout, so
+ * every node is dirty and has its state, including its focus, copied.
+ *
+ * The windows are containers without views, since views need client
+ * surfaces, so the transactions apply right away instead of waiting for
+ * configures.
+ */
+
+#define COLUMNS 8
+
+static void add_windows(struct sway_workspace *ws, list_t *columns,
+		list_t *windows, int count) {
+	while (columns->length < COLUMNS) {
+		struct sway_container *column = container_create(NULL);
+		column->layout = L_VERT;
+		workspace_add_tiling(ws, column);
+		list_add(columns, column);
+	}
+	while (windows->length < count) {
+		struct sway_container *column =
+			columns->items[windows->length % columns->length];
+		struct sway_container *con = container_create(NULL);
+		container_add_child(column, con);
+		list_add(windows, con);
+	}
+}
+
+static void run(struct sway_workspace *ws, list_t *windows, int commits) {
+	struct sway_seat *seat = input_manager_get_default_seat();
+	uint64_t total_nsec = 0, max_nsec = 0;
+	int nodes = 0;
+	for (int i = 0; i < commits; ++i) {
+		seat_set_focus_container(seat,
+				windows->items[i * 7919 % windows->length]);
+		ws->layout = ws->layout == L_HORIZ ? L_VERT : L_HORIZ;
+		arrange_root();
+		nodes += server.dirty_nodes->length;
+
+		uint64_t start = bench_now_nsec(CLOCK_MONOTONIC);
+		transaction_commit_dirty();
+		uint64_t nsec = bench_now_nsec(CLOCK_MONOTONIC) - start;
+		total_nsec += nsec;
+		if (nsec > max_nsec) {
+			max_nsec = nsec;
+		}
+	}
+	printf("%8d %12.3f %12.3f %12.1f\n", windows->length,
+			total_nsec / 1000000.0 / commits, max_nsec / 1000000.0,
+			(double)nodes / commits);
+}
+
+int main(int argc, char **argv) {
+	static struct option long_options[] = {
+		{"help", no_argument, NULL, 'h'},
+		{"windows", required_argument, NULL, 'n'},
+		{"commits", required_argument, NULL, 'c'},
+		{"debug", no_argument, NULL, 'd'},
+		{0, 0, 0, 0}
+	};
+
+	const char *usage =
+		"Usage: sway-transaction-bench [options]\n"
+		"\n"
+		"  -h, --help           Show help message and quit.\n"
+		"  -n, --windows <n>    Largest number of windows. The benchmark starts\n"
+		"                       with 16 and doubles up to n. Defaults to 1024.\n"
+		"  -c, --commits <n>    Commits per window count. Defaults to 50.\n"
+		"  -d, --debug          Enables full logging.\n"
+		"\n";
+
+	int max_windows = 1024, commits = 50;
+	bool verbose = false;
+
+	int c;
+	while ((c = getopt_long(argc, argv, "hn:c:d", long_options, NULL)) != -1) {
+		switch (c) {
+		case 'h':
+			fprintf(stdout, "%s", usage);
+			exit(EXIT_SUCCESS);
+		case 'n':
+			max_windows = atoi(optarg);
+			break;
+		case 'c':
+			commits = atoi(optarg);
+			break;
+		case 'd':
+			verbose = true;
+			break;
+		default:
+			fprintf(stderr, "%s", usage);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (max_windows < 1 || commits < 1) {
+		fprintf(stderr, "%s", usage);
+		exit(EXIT_FAILURE);
+	}
+
+	struct sway_output *output = bench_init(1920, 1080, verbose);
+	if (!output) {
+		return 1;
+	}
+
+	struct sway_workspace *ws = output_get_active_workspace(output);
+	list_t *columns = create_list();
+	list_t *windows = create_list();
+
+	printf("%8s %12s %12s %12s\n", "windows", "commit (ms)", "max (ms)",
+			"dirty nodes");
+	for (int count = 16; ; count *= 2) {
+		if (count > max_windows) {
+			count = max_windows;
+		}
+		add_windows(ws, columns, windows, count);
+		run(ws, windows, commits);
+		if (count == max_windows) {
+			break;
+		}
+	}
+
+	list_free(columns);
+	list_free(windows);
+	bench_fini();
+	return 0;
+}
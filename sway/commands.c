@@ -197,6 +197,54 @@ static void set_config_node(struct sway_node *node) {
 	}
 }
 
+/**
+ * Runs a single command, either on the focused node or on each of the
+ * containers matched by the current criteria. Returns false if the rest of
+ * the command list should be skipped.
+ */
+static bool run_command(struct cmd_handler *handler, int argc, char **argv,
+		list_t *containers, struct sway_seat *seat,
+		struct sway_container *con, list_t *res_list) {
+	if (!config->handler_context.using_criteria) {
+		// The container or workspace which this command will run on.
+		struct sway_node *node = con ? &con->node :
+				seat_get_focus_inactive(seat, &root->node);
+		set_config_node(node);
+		struct cmd_results *res = handler->handle(argc-1, argv+1);
+		list_add(res_list, res);
+		return res->status != CMD_INVALID;
+	}
+
+	if (containers->length == 0) {
+		list_add(res_list,
+				cmd_results_new(CMD_FAILURE, "No matching node."));
+		return true;
+	}
+
+	struct cmd_results *fail_res = NULL;
+	for (int i = 0; i < containers->length; ++i) {
+		struct sway_container *container = containers->items[i];
+		set_config_node(&container->node);
+		struct cmd_results *res = handler->handle(argc-1, argv+1);
+		if (res->status == CMD_SUCCESS) {
+			free_cmd_results(res);
+		} else {
+			// last failure will take precedence
+			if (fail_res) {
+				free_cmd_results(fail_res);
+			}
+			fail_res = res;
+			if (res->status == CMD_INVALID) {
+				list_add(res_list, fail_res);
+				return false;
+			}
+		}
+	}
+	list_add(res_list,
+			fail_res ? fail_res : cmd_results_new(CMD_SUCCESS, NULL));
+	return true;
+}
+
 list_t *execute_command(char *_exec, struct sway_seat *seat,
 		struct sway_container *con) {
 	char *cmd;
@@ -278,49 +326,277 @@ list_t *execute_command(char *_exec, struct sway_seat *seat,
 			argv[i] = do_var_replacement(argv[i]);
 		}
 
-		if (!config->handler_context.using_criteria) {
-			// The container or workspace which this command will run on.
-			struct sway_node *node = con ? &con->node :
-					seat_get_focus_inactive(seat, &root->node);
-			set_config_node(node);
-			struct cmd_results *res = handler->handle(argc-1, argv+1);
-			list_add(res_list, res);
-			if (res->status == CMD_INVALID) {
-				free_argv(argc, argv);
-				goto cleanup;
+		bool proceed = run_command(handler, argc, argv, containers,
+				seat, con, res_list);
+		free_argv(argc, argv);
+		if (!proceed) {
+			goto cleanup;
+		}
+	} while(head);
+cleanup:
+	free(exec);
+	list_free(containers);
+	return res_list;
+}
+
+/**
+ * A single command of a compiled command list.
+ */
+struct cmd_list_command {
+	char *cmd; // for logging
+	bool starts_list; // first command after a ';'
+	struct criteria *criteria; // only set if starts_list is
+	struct cmd_handler *handler; // NULL for empty commands
+	int argc;
+	char **argv; // points into strings
+	char *strings;
+	size_t strings_size;
+	bool *expand; // whether argv[i] needs variable replacement
+};
+
+struct cmd_list {
+	char *source;
+	list_t *commands; // struct cmd_list_command
+	// A command may destroy the binding or criteria owning the list while
+	// it runs, so execute_cmd_list holds its own reference
+	int refs;
+};
+
+static void cmd_list_command_destroy(struct cmd_list_command *command) {
+	if (!command) {
+		return;
+	}
+	if (command->criteria) {
+		criteria_destroy(command->criteria);
+	}
+	free(command->cmd);
+	free(command->argv);
+	free(command->strings);
+	free(command->expand);
+	free(command);
+}
+
+void cmd_list_destroy(struct cmd_list *list) {
+	if (!list || --list->refs > 0) {
+		return;
+	}
+	if (list->commands) {
+		for (int i = 0; i < list->commands->length; ++i) {
+			cmd_list_command_destroy(list->commands->items[i]);
+		}
+		list_free(list->commands);
+	}
+	free(list->source);
+	free(list);
+}
+
+static bool cmd_list_command_init(struct cmd_list_command *command,
+		char *cmd) {
+	command->cmd = strdup(cmd);
+	if (!command->cmd) {
+		return false;
+	}
+	if (strcmp(cmd, "") == 0) {
+		return true;
+	}
+
+	int argc;
+	char **argv = split_args(cmd, &argc);
+	if (!argc) {
+		free_argv(argc, argv);
+		return false;
+	}
+	if (strcmp(argv[0], "exec") != 0 &&
+			strcmp(argv[0], "exec_always") != 0 &&
+			strcmp(argv[0], "mode") != 0) {
+		for (int i = 1; i < argc; ++i) {
+			if (*argv[i] == '\"' || *argv[i] == '\'') {
+				strip_quotes(argv[i]);
 			}
-		} else if (containers->length == 0) {
-			list_add(res_list,
-					cmd_results_new(CMD_FAILURE, "No matching node."));
-		} else {
-			struct cmd_results *fail_res = NULL;
-			for (int i = 0; i < containers->length; ++i) {
-				struct sway_container *container = containers->items[i];
-				set_config_node(&container->node);
-				struct cmd_results *res = handler->handle(argc-1, argv+1);
-				if (res->status == CMD_SUCCESS) {
-					free_cmd_results(res);
-				} else {
-					// last failure will take precedence
-					if (fail_res) {
-						free_cmd_results(fail_res);
-					}
-					fail_res = res;
-					if (res->status == CMD_INVALID) {
-						list_add(res_list, fail_res);
-						free_argv(argc, argv);
-						goto cleanup;
-					}
+		}
+	}
+
+	// Bindings and criteria only ever run once the config is active
+	command->handler = find_handler(argv[0], command_handlers,
+			sizeof(command_handlers));
+	if (!command->handler) {
+		command->handler = find_handler(argv[0], handlers, sizeof(handlers));
+	}
+	if (!command->handler) {
+		free_argv(argc, argv);
+		return false;
+	}
+
+	command->argc = argc;
+	command->argv = calloc(argc, sizeof(char *));
+	command->expand = calloc(argc, sizeof(bool));
+	for (int i = 0; i < argc; ++i) {
+		command->strings_size += strlen(argv[i]) + 1;
+	}
+	command->strings = malloc(command->strings_size);
+	if (!command->argv || !command->expand || !command->strings) {
+		free_argv(argc, argv);
+		return false;
+	}
+
+	char *strings = command->strings;
+	int first_var = command->handler->handle == cmd_set ? 2 : 1;
+	for (int i = 0; i < argc; ++i) {
+		size_t len = strlen(argv[i]) + 1;
+		memcpy(strings, argv[i], len);
+		command->argv[i] = strings;
+		// Only arguments which still reference a variable have to be
+		// expanded when the command runs
+		command->expand[i] = i >= first_var && strchr(argv[i], '$');
+		strings += len;
+	}
+	free_argv(argc, argv);
+	return true;
+}
+
+struct cmd_list *cmd_list_compile(const char *source) {
+	struct cmd_list *list = calloc(1, sizeof(struct cmd_list));
+	if (!list) {
+		return NULL;
+	}
+	list->refs = 1;
+	list->source = strdup(source);
+	list->commands = create_list();
+	char *exec = strdup(source);
+	if (!list->source || !list->commands || !exec) {
+		goto error;
+	}
+
+	char *head = exec;
+	char matched_delim = ';';
+	do {
+		for (; isspace(*head); ++head) {}
+		struct cmd_list_command *command =
+			calloc(1, sizeof(struct cmd_list_command));
+		if (!command) {
+			goto error;
+		}
+		list_add(list->commands, command);
+
+		if (matched_delim == ';') {
+			command->starts_list = true;
+			if (*head == '[') {
+				char *error = NULL;
+				command->criteria = criteria_parse(head, &error);
+				if (!command->criteria) {
+					free(error);
+					goto error;
 				}
+				head += strlen(command->criteria->raw);
+				for (; isspace(*head); ++head) {}
 			}
-			list_add(res_list,
-					fail_res ? fail_res : cmd_results_new(CMD_SUCCESS, NULL));
 		}
-		free_argv(argc, argv);
-	} while(head);
-cleanup:
+
+		char *cmd = argsep(&head, ";,", &matched_delim);
+		for (; isspace(*cmd); ++cmd) {}
+		if (!cmd_list_command_init(command, cmd)) {
+			goto error;
+		}
+	} while (head);
+
+	free(exec);
+	return list;
+
+error:
+	// Let execute_command report whatever is wrong with the command list
 	free(exec);
+	cmd_list_destroy(list);
+	return NULL;
+}
+
+/**
+ * Handlers are free to modify their arguments, so every run gets its own copy
+ * of the precompiled ones.
+ */
+static char **cmd_list_command_argv(struct cmd_list_command *command) {
+	char **argv = malloc(command->argc * sizeof(char *) +
+			command->strings_size);
+	if (!argv) {
+		return NULL;
+	}
+	char *strings = (char *)(argv + command->argc);
+	memcpy(strings, command->strings, command->strings_size);
+	for (int i = 0; i < command->argc; ++i) {
+		argv[i] = strings + (command->argv[i] - command->strings);
+		if (command->expand[i]) {
+			argv[i] = do_var_replacement(strdup(argv[i]));
+		}
+	}
+	return argv;
+}
+
+static void cmd_list_command_free_argv(struct cmd_list_command *command,
+		char **argv) {
+	for (int i = 0; i < command->argc; ++i) {
+		if (command->expand[i]) {
+			free(argv[i]);
+		}
+	}
+	free(argv);
+}
+
+list_t *execute_cmd_list(struct cmd_list *list, struct sway_seat *seat,
+		struct sway_container *con) {
+	if (config->reading || !config->active) {
+		// The handlers were looked up for an active config
+		return execute_command(list->source, seat, con);
+	}
+
+	if (seat == NULL) {
+		// passing a NULL seat means we just pick the default seat
+		seat = input_manager_get_default_seat();
+		if (!sway_assert(seat, "could not find a seat to run the command on")) {
+			return NULL;
+		}
+	}
+
+	list_t *res_list = create_list();
+	if (!res_list) {
+		return NULL;
+	}
+
+	config->handler_context.seat = seat;
+	list->refs++;
+
+	list_t *containers = NULL;
+	for (int i = 0; i < list->commands->length; ++i) {
+		struct cmd_list_command *command = list->commands->items[i];
+		if (command->starts_list) {
+			config->handler_context.using_criteria = false;
+			if (command->criteria) {
+				list_free(containers);
+				containers = criteria_get_containers(command->criteria);
+				config->handler_context.using_criteria = true;
+			}
+		}
+
+		if (!command->handler) {
+			sway_log(SWAY_INFO, "Ignoring empty command.");
+			continue;
+		}
+		sway_log(SWAY_INFO, "Handling command '%s'", command->cmd);
+
+		char **argv = cmd_list_command_argv(command);
+		if (!argv) {
+			list_add(res_list, cmd_results_new(CMD_FAILURE,
+					"Unable to allocate command arguments"));
+			break;
+		}
+		bool proceed = run_command(command->handler, command->argc, argv,
+				containers, seat, con, res_list);
+		cmd_list_command_free_argv(command, argv);
+		if (!proceed) {
+			break;
+		}
+	}
+
 	list_free(containers);
+	cmd_list_destroy(list);
 	return res_list;
 }
 
@@ -410,7 +686,12 @@ struct cmd_results *config_command(char *exec, char **new_block) {
 	}
 
 	// Run command
+	uint64_t start = config->profile ? config_profile_now() : 0;
 	results = handler->handle(argc - 1, argv + 1);
+	if (config->profile) {
+		config_profile_add(config->profile, CONFIG_PROFILE_HANDLER,
+				handler->command, config_profile_now() - start);
+	}
 
 cleanup:
 	free_argv(argc, argv);
@@ -11,6 +11,7 @@
 #include "sway/input/cursor.h"
 #include "sway/input/keyboard.h"
 #include "sway/ipc-server.h"
+#include "intern.h"
 #include "list.h"
 #include "log.h"
 #include "stringop.h"
@@ -25,8 +26,8 @@ void free_sway_binding(struct sway_binding *binding) {
 
 	list_free_items_and_destroy(binding->keys);
 	list_free_items_and_destroy(binding->syms);
-	free(binding->input);
 	free(binding->command);
+	cmd_list_destroy(binding->compiled_command);
 	free(binding);
 }
 
@@ -63,7 +64,7 @@ static bool binding_switch_compare(struct sway_switch_binding *binding_a,
  */
 static bool binding_key_compare(struct sway_binding *binding_a,
 		struct sway_binding *binding_b) {
-	if (strcmp(binding_a->input, binding_b->input) != 0) {
+	if (binding_a->input != binding_b->input) {
 		return false;
 	}
 
@@ -340,7 +341,7 @@ static struct cmd_results *cmd_bindsym_or_bindcode(int argc, char **argv,
 	if (!binding) {
 		return cmd_results_new(CMD_FAILURE, "Unable to allocate binding");
 	}
-	binding->input = strdup("*");
+	binding->input = intern_string("*");
 	binding->keys = create_list();
 	binding->group = XKB_LAYOUT_INVALID;
 	binding->modifiers = 0;
@@ -369,8 +370,8 @@ static struct cmd_results *cmd_bindsym_or_bindcode(int argc, char **argv,
 			exclude_titlebar = true;
 		} else if (strncmp("--input-device=", argv[0],
 					strlen("--input-device=")) == 0) {
-			free(binding->input);
-			binding->input = strdup(argv[0] + strlen("--input-device="));
+			binding->input =
+				intern_string(argv[0] + strlen("--input-device="));
 		} else if (strcmp("--no-warn", argv[0]) == 0) {
 			warn = false;
 		} else if (strcmp("--no-repeat", argv[0]) == 0) {
@@ -486,6 +487,7 @@ static struct cmd_results *cmd_bindsym_or_bindcode(int argc, char **argv,
 	}
 
 	binding->command = join_args(argv + 1, argc - 1);
+	binding->compiled_command = cmd_list_compile(binding->command);
 	binding->order = binding_order++;
 	return binding_add(binding, mode_bindings, bindtype, argv[0], warn);
 }
@@ -609,6 +611,7 @@ void seat_execute_command(struct sway_seat *seat, struct sway_binding *binding)
 		}
 		memcpy(deferred, binding, sizeof(struct sway_binding));
 		deferred->command = binding->command ? strdup(binding->command) : NULL;
+		deferred->compiled_command = NULL;
 		list_add(seat->deferred_bindings, deferred);
 		return;
 	}
@@ -627,7 +630,9 @@ void seat_execute_command(struct sway_seat *seat, struct sway_binding *binding)
 		}
 	}
 
-	list_t *res_list = execute_command(binding->command, seat, con);
+	list_t *res_list = binding->compiled_command ?
+		execute_cmd_list(binding->compiled_command, seat, con) :
+		execute_command(binding->command, seat, con);
 	bool success = true;
 	for (int i = 0; i < res_list->length; ++i) {
 		struct cmd_results *results = res_list->items[i];
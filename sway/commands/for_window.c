@@ -30,6 +30,7 @@ struct cmd_results *cmd_for_window(int argc, char **argv) {
 		return cmd_results_new(CMD_SUCCESS, NULL);
 	}
 
+	criteria->compiled_cmdlist = cmd_list_compile(criteria->cmdlist);
 	list_add(config->criteria, criteria);
 	sway_log(SWAY_DEBUG, "for_window: '%s' -> '%s' added", criteria->raw, criteria->cmdlist);
 
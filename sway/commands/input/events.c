@@ -89,7 +89,7 @@ static void toggle_send_events(int argc, char **argv) {
 			if (type && strcmp(input_device_get_type(device), type) != 0) {
 				continue;
 			}
-		} else if (strcmp(ic->identifier, device->identifier) != 0) {
+		} else if (ic->identifier != device->identifier) {
 			continue;
 		}
 
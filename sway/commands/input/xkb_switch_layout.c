@@ -70,7 +70,7 @@ struct cmd_results *input_cmd_xkb_switch_layout(int argc, char **argv) {
 	wl_list_for_each(dev, &server.input->devices, link) {
 		if (strcmp(ic->identifier, "*") != 0 &&
 				strcmp(ic->identifier, "type:keyboard") != 0 &&
-				strcmp(ic->identifier, dev->identifier) != 0) {
+				ic->identifier != dev->identifier) {
 			continue;
 		}
 		if (dev->wlr_device->type != WLR_INPUT_DEVICE_KEYBOARD) {
@@ -14,6 +14,9 @@ static void rebuild_textures_iterator(struct sway_container *con, void *data) {
 	container_update_title_textures(con);
 }
 
+// Time spent validating the config in cmd_reload, for the config profile
+static uint64_t validate_nsec = 0;
+
 static void do_reload(void *data) {
 	// store bar ids to check against new bars for barconfig_update events
 	list_t *bar_ids = create_list();
@@ -33,8 +36,12 @@ static void do_reload(void *data) {
 		return;
 	}
 
+	config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "validate",
+			validate_nsec);
+
 	ipc_event_workspace(NULL, NULL, "reload");
 
+	uint64_t start = config_profile_now();
 	load_swaybars();
 
 	for (int i = 0; i < config->bars->length; ++i) {
@@ -47,11 +54,21 @@ static void do_reload(void *data) {
 		}
 	}
 	list_free_items_and_destroy(bar_ids);
+	config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "bars",
+			config_profile_now() - start);
 
+	start = config_profile_now();
 	config_update_font_height(true);
 	root_for_each_container(rebuild_textures_iterator, NULL);
+	config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "textures",
+			config_profile_now() - start);
 
+	start = config_profile_now();
 	arrange_root();
+	config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "arrange",
+			config_profile_now() - start);
+
+	config_profile_log(config->profile);
 }
 
 struct cmd_results *cmd_reload(int argc, char **argv) {
@@ -65,9 +82,11 @@ struct cmd_results *cmd_reload(int argc, char **argv) {
 		path = config->current_config_path;
 	}
 
+	uint64_t start = config_profile_now();
 	if (!load_main_config(path, true, true)) {
 		return cmd_results_new(CMD_FAILURE, "Error(s) reloading config.");
 	}
+	validate_nsec = config_profile_now() - start;
 
 	// The reload command frees a lot of stuff, so to avoid use-after-frees
 	// we schedule the reload to happen using an idle event.
@@ -2,6 +2,7 @@
 #include <string.h>
 #include "sway/commands.h"
 #include "sway/config.h"
+#include "intern.h"
 #include "stringop.h"
 
 struct cmd_results *seat_cmd_attach(int argc, char **argv) {
@@ -21,7 +22,7 @@ struct cmd_results *seat_cmd_attach(int argc, char **argv) {
 		return cmd_results_new(CMD_FAILURE,
 				"Failed to allocate seat attachment config");
 	}
-	attachment->identifier = strdup(argv[0]);
+	attachment->identifier = intern_string(argv[0]);
 	list_add(config->handler_context.seat_config->attachments, attachment);
 
 	return cmd_results_new(CMD_SUCCESS, NULL);
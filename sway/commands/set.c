@@ -8,13 +8,6 @@
 #include "log.h"
 #include "stringop.h"
 
-// sort in order of longest->shortest
-static int compare_set_qsort(const void *_l, const void *_r) {
-	struct sway_variable const *l = *(void **)_l;
-	struct sway_variable const *r = *(void **)_r;
-	return strlen(r->name) - strlen(l->name);
-}
-
 void free_sway_variable(struct sway_variable *var) {
 	if (!var) {
 		return;
@@ -34,16 +27,8 @@ struct cmd_results *cmd_set(int argc, char **argv) {
 		return cmd_results_new(CMD_INVALID, "variable '%s' must start with $", argv[0]);
 	}
 
-	struct sway_variable *var = NULL;
 	// Find old variable if it exists
-	int i;
-	for (i = 0; i < config->symbols->length; ++i) {
-		var = config->symbols->items[i];
-		if (strcmp(var->name, argv[0]) == 0) {
-			break;
-		}
-		var = NULL;
-	}
+	struct sway_variable *var = find_sway_variable(argv[0]);
 	if (var) {
 		free(var->value);
 	} else {
@@ -52,8 +37,11 @@ struct cmd_results *cmd_set(int argc, char **argv) {
 			return cmd_results_new(CMD_FAILURE, "Unable to allocate variable");
 		}
 		var->name = strdup(argv[0]);
-		list_add(config->symbols, var);
-		list_qsort(config->symbols, compare_set_qsort);
+		var->value = NULL;
+		if (!var->name || !store_sway_variable(var)) {
+			free_sway_variable(var);
+			return cmd_results_new(CMD_FAILURE, "Unable to allocate variable");
+		}
 	}
 	var->value = join_args(argv + 1, argc - 1);
 	return cmd_results_new(CMD_SUCCESS, NULL);
@@ -22,6 +22,7 @@
 #include "sway/config.h"
 #include "sway/criteria.h"
 #include "sway/desktop/transaction.h"
+#include "sway/server.h"
 #include "sway/swaynag.h"
 #include "sway/tree/arrange.h"
 #include "sway/tree/root.h"
@@ -85,6 +86,29 @@ static void free_mode(struct sway_mode *mode) {
 	free(mode);
 }
 
+/**
+ * A node in the prefix tree over variable names. Children are sorted by key so
+ * that the longest variable name at a position can be found with one walk.
+ */
+struct sway_variable_node {
+	char key;
+	struct sway_variable *var; // variable whose name ends here, or NULL
+	list_t *children; // struct sway_variable_node
+};
+
+static void free_variable_node(struct sway_variable_node *node) {
+	if (!node) {
+		return;
+	}
+	if (node->children) {
+		for (int i = 0; i < node->children->length; ++i) {
+			free_variable_node(node->children->items[i]);
+		}
+		list_free(node->children);
+	}
+	free(node);
+}
+
 void free_config(struct sway_config *config) {
 	if (!config) {
 		return;
@@ -99,6 +123,8 @@ void free_config(struct sway_config *config) {
 		}
 		list_free(config->symbols);
 	}
+	free_variable_node(config->symbol_tree);
+	config_profile_destroy(config->profile);
 	if (config->modes) {
 		for (int i = 0; i < config->modes->length; ++i) {
 			free_mode(config->modes->items[i]);
@@ -201,6 +227,8 @@ static void config_defaults(struct sway_config *config) {
 	config->swaynag_config_errors.detailed = true;
 
 	if (!(config->symbols = create_list())) goto cleanup;
+	if (debug.profile_config &&
+			!(config->profile = config_profile_create())) goto cleanup;
 	if (!(config->modes = create_list())) goto cleanup;
 	if (!(config->bars = create_list())) goto cleanup;
 	if (!(config->workspace_configs = create_list())) goto cleanup;
@@ -390,8 +418,11 @@ static bool load_config(const char *path, struct sway_config *config,
 		return false;
 	}
 
+	uint64_t start = config_profile_now();
 	bool config_load_success = read_config(f, config, swaynag);
 	fclose(f);
+	config_profile_add(config->profile, CONFIG_PROFILE_FILE, path,
+			config_profile_now() - start);
 
 	if (!config_load_success) {
 		sway_log(SWAY_ERROR, "Error(s) loading config!");
@@ -442,8 +473,6 @@ bool load_main_config(const char *file, bool is_active, bool validating) {
 			if (old_config->swaynag_config_errors.client != NULL) {
 				wl_client_destroy(old_config->swaynag_config_errors.client);
 			}
-
-			input_manager_reset_all_inputs();
 		}
 	}
 
@@ -501,8 +530,11 @@ bool load_main_config(const char *file, bool is_active, bool validating) {
 	}
 	*/
 
+	uint64_t start = config_profile_now();
 	success = success && load_config(path, config,
 			&config->swaynag_config_errors);
+	config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "read",
+			config_profile_now() - start);
 
 	if (validating) {
 		free_config(config);
@@ -513,22 +545,56 @@ bool load_main_config(const char *file, bool is_active, bool validating) {
 	if (is_active && !validating) {
 		input_manager_verify_fallback_seat();
 
-		for (int i = 0; i < config->input_configs->length; i++) {
-			input_manager_apply_input_config(config->input_configs->items[i]);
-		}
+		// Only reconfigure devices if the parsed configs actually changed,
+		// reconfiguring them is expensive and can drop frames
+		start = config_profile_now();
+		if (input_configs_changed(old_config)) {
+			input_manager_reset_all_inputs();
 
-		for (int i = 0; i < config->input_type_configs->length; i++) {
-			input_manager_apply_input_config(
-					config->input_type_configs->items[i]);
+			for (int i = 0; i < config->input_configs->length; i++) {
+				input_manager_apply_input_config(
+						config->input_configs->items[i]);
+			}
+
+			for (int i = 0; i < config->input_type_configs->length; i++) {
+				input_manager_apply_input_config(
+						config->input_type_configs->items[i]);
+			}
+		} else {
+			sway_log(SWAY_DEBUG, "Input configs unchanged, not reapplying");
+			// The new bindings still need to be translated with the keymap
+			for (int i = 0; i < config->input_configs->length; i++) {
+				struct input_config *ic = config->input_configs->items[i];
+				if (ic->xkb_layout || ic->xkb_file) {
+					translate_keysyms(ic);
+					break;
+				}
+			}
 		}
+		config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "inputs",
+				config_profile_now() - start);
 
-		for (int i = 0; i < config->seat_configs->length; i++) {
-			input_manager_apply_seat_config(config->seat_configs->items[i]);
+		start = config_profile_now();
+		if (seat_configs_changed(old_config)) {
+			for (int i = 0; i < config->seat_configs->length; i++) {
+				input_manager_apply_seat_config(config->seat_configs->items[i]);
+			}
+		} else {
+			sway_log(SWAY_DEBUG, "Seat configs unchanged, not reapplying");
 		}
 		sway_switch_retrigger_bindings_for_all();
+		config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "seats",
+				config_profile_now() - start);
 
-		reset_outputs();
+		start = config_profile_now();
+		if (output_configs_changed(old_config)) {
+			reset_outputs();
+		} else {
+			sway_log(SWAY_DEBUG, "Output configs unchanged, not reapplying");
+		}
 		spawn_swaybg();
+		config_profile_add(config->profile, CONFIG_PROFILE_PHASE, "outputs",
+				config_profile_now() - start);
 
 		config->reloading = false;
 		if (config->swaynag_config_errors.client != NULL) {
@@ -537,8 +603,11 @@ bool load_main_config(const char *file, bool is_active, bool validating) {
 	}
 
 	if (old_config) {
+		start = config_profile_now();
 		destroy_removed_seats(old_config, config);
 		free_config(old_config);
+		config_profile_add(config->profile, CONFIG_PROFILE_PHASE,
+				"free old config", config_profile_now() - start);
 	}
 	config->reading = false;
 	return success;
@@ -900,55 +969,162 @@ void config_add_swaynag_warning(char *fmt, ...) {
 	}
 }
 
+/**
+ * Binary searches the children of node for key. Returns the child, or NULL and
+ * the index it would have to be inserted at.
+ */
+static struct sway_variable_node *variable_node_child(
+		struct sway_variable_node *node, char key, int *index) {
+	int lo = 0, hi = node->children ? node->children->length : 0;
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		struct sway_variable_node *child = node->children->items[mid];
+		if (child->key == key) {
+			return child;
+		} else if ((unsigned char)child->key < (unsigned char)key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (index) {
+		*index = lo;
+	}
+	return NULL;
+}
+
+struct sway_variable *find_sway_variable(const char *name) {
+	struct sway_variable_node *node = config->symbol_tree;
+	for (const char *c = name; node && *c; ++c) {
+		node = variable_node_child(node, *c, NULL);
+	}
+	return node ? node->var : NULL;
+}
+
+bool store_sway_variable(struct sway_variable *var) {
+	if (!config->symbol_tree &&
+			!(config->symbol_tree = calloc(1, sizeof(*config->symbol_tree)))) {
+		return false;
+	}
+	struct sway_variable_node *node = config->symbol_tree;
+	for (const char *c = var->name; *c; ++c) {
+		int index;
+		struct sway_variable_node *child =
+			variable_node_child(node, *c, &index);
+		if (!child) {
+			if (!node->children && !(node->children = create_list())) {
+				return false;
+			}
+			if (!(child = calloc(1, sizeof(*child)))) {
+				return false;
+			}
+			child->key = *c;
+			list_insert(node->children, index, child);
+		}
+		node = child;
+	}
+	node->var = var;
+	list_add(config->symbols, var);
+	return true;
+}
+
+/**
+ * Returns the variable with the longest name that is a prefix of str.
+ */
+static struct sway_variable *match_variable(const char *str) {
+	struct sway_variable *match = NULL;
+	struct sway_variable_node *node = config->symbol_tree;
+	for (const char *c = str; node && *c; ++c) {
+		if ((node = variable_node_child(node, *c, NULL)) && node->var) {
+			match = node->var;
+		}
+	}
+	return match;
+}
+
+static bool append_str(char **buf, size_t *len, size_t *cap,
+		const char *str, size_t n) {
+	if (*len + n + 1 > *cap) {
+		size_t new_cap = *cap * 2;
+		while (*len + n + 1 > new_cap) {
+			new_cap *= 2;
+		}
+		char *new_buf = realloc(*buf, new_cap);
+		if (!new_buf) {
+			return false;
+		}
+		*buf = new_buf;
+		*cap = new_cap;
+	}
+	memcpy(*buf + *len, str, n);
+	*len += n;
+	(*buf)[*len] = '\0';
+	return true;
+}
+
 char *do_var_replacement(char *str) {
-	int i;
-	char *find = str;
-	while ((find = strchr(find, '$'))) {
-		// Skip if escaped.
-		if (find > str && find[-1] == '\\') {
-			if (find == str + 1 || !(find > str + 1 && find[-2] == '\\')) {
-				++find;
-				continue;
+	char *find = strchr(str, '$');
+	if (!find) {
+		return str;
+	}
+
+	// Build the result in one pass, so that expanding a line costs time
+	// proportional to its length rather than to the number of variables.
+	size_t len = 0, cap = strlen(str) + 1;
+	char *out = malloc(cap);
+	if (!out) {
+		sway_log(SWAY_ERROR, "Unable to allocate buffer for variable expansion");
+		return str;
+	}
+	out[0] = '\0';
+
+	const char *rest = str;
+	for (; find; find = strchr(rest, '$')) {
+		if (!append_str(&out, &len, &cap, rest, find - rest)) {
+			goto error;
+		}
+		rest = find;
+		// Skip if escaped. Check the output, since an expanded value may end
+		// in a backslash.
+		if (len > 0 && out[len - 1] == '\\' &&
+				!(len > 1 && out[len - 2] == '\\')) {
+			if (!append_str(&out, &len, &cap, "$", 1)) {
+				goto error;
 			}
+			rest = find + 1;
+			continue;
 		}
 		// Unescape double $ and move on
 		if (find[1] == '$') {
-			size_t length = strlen(find + 1);
-			memmove(find, find + 1, length);
-			find[length] = '\0';
-			++find;
+			if (!append_str(&out, &len, &cap, "$", 1)) {
+				goto error;
+			}
+			rest = find + 2;
 			continue;
 		}
-		// Find matching variable
-		for (i = 0; i < config->symbols->length; ++i) {
-			struct sway_variable *var = config->symbols->items[i];
-			int vnlen = strlen(var->name);
-			if (strncmp(find, var->name, vnlen) == 0) {
-				int vvlen = strlen(var->value);
-				char *newstr = malloc(strlen(str) - vnlen + vvlen + 1);
-				if (!newstr) {
-					sway_log(SWAY_ERROR,
-						"Unable to allocate replacement "
-						"during variable expansion");
-					break;
-				}
-				char *newptr = newstr;
-				int offset = find - str;
-				strncpy(newptr, str, offset);
-				newptr += offset;
-				strncpy(newptr, var->value, vvlen);
-				newptr += vvlen;
-				strcpy(newptr, find + vnlen);
-				free(str);
-				str = newstr;
-				find = str + offset + vvlen;
-				break;
+		struct sway_variable *var = match_variable(find);
+		if (var) {
+			if (!append_str(&out, &len, &cap,
+					var->value, strlen(var->value))) {
+				goto error;
 			}
-		}
-		if (i == config->symbols->length) {
-			++find;
+			rest = find + strlen(var->name);
+		} else {
+			if (!append_str(&out, &len, &cap, "$", 1)) {
+				goto error;
+			}
+			rest = find + 1;
 		}
 	}
+	if (!append_str(&out, &len, &cap, rest, strlen(rest))) {
+		goto error;
+	}
+	free(str);
+	return out;
+
+error:
+	sway_log(SWAY_ERROR, "Unable to allocate replacement during variable expansion");
+	free(out);
 	return str;
 }
 
@@ -4,7 +4,9 @@
 #include <float.h>
 #include "sway/config.h"
 #include "sway/input/keyboard.h"
+#include "intern.h"
 #include "log.h"
+#include "stringop.h"
 
 struct input_config *new_input_config(const char* identifier) {
 	struct input_config *input = calloc(1, sizeof(struct input_config));
@@ -13,7 +15,7 @@ struct input_config *new_input_config(const char* identifier) {
 		return NULL;
 	}
 	sway_log(SWAY_DEBUG, "new_input_config(%s)", identifier);
-	if (!(input->identifier = strdup(identifier))) {
+	if (!(input->identifier = intern_string(identifier))) {
 		free(input);
 		sway_log(SWAY_DEBUG, "Unable to allocate input config");
 		return NULL;
@@ -177,7 +179,7 @@ static bool validate_wildcard_on_all(struct input_config *wildcard,
 		char **error) {
 	for (int i = 0; i < config->input_configs->length; i++) {
 		struct input_config *ic = config->input_configs->items[i];
-		if (strcmp(wildcard->identifier, ic->identifier) != 0) {
+		if (wildcard->identifier != ic->identifier) {
 			sway_log(SWAY_DEBUG, "Validating xkb merge of * on %s",
 					ic->identifier);
 			if (!validate_xkb_merge(ic, wildcard, error)) {
@@ -201,7 +203,7 @@ static bool validate_wildcard_on_all(struct input_config *wildcard,
 static void merge_wildcard_on_all(struct input_config *wildcard) {
 	for (int i = 0; i < config->input_configs->length; i++) {
 		struct input_config *ic = config->input_configs->items[i];
-		if (strcmp(wildcard->identifier, ic->identifier) != 0) {
+		if (wildcard->identifier != ic->identifier) {
 			sway_log(SWAY_DEBUG, "Merging input * config on %s", ic->identifier);
 			merge_input_config(ic, wildcard);
 		}
@@ -252,7 +254,7 @@ static void merge_type_on_existing(struct input_config *type_wildcard) {
 static const char *set_input_type(struct input_config *ic) {
 	struct sway_input_device *input_device;
 	wl_list_for_each(input_device, &server.input->devices, link) {
-		if (strcmp(input_device->identifier, ic->identifier) == 0) {
+		if (input_device->identifier == ic->identifier) {
 			ic->input_type = input_device_get_type(input_device);
 			break;
 		}
@@ -296,7 +298,8 @@ struct input_config *store_input_config(struct input_config *ic,
 		}
 	}
 
-	i = list_seq_find(config->input_configs, input_identifier_cmp, "*");
+	i = list_seq_find(config->input_configs, input_identifier_cmp,
+			intern_string("*"));
 	if (!current && i >= 0) {
 		current = new_input_config(ic->identifier);
 		merge_input_config(current, config->input_configs->items[i]);
@@ -348,7 +351,6 @@ void free_input_config(struct input_config *ic) {
 	if (!ic) {
 		return;
 	}
-	free(ic->identifier);
 	free(ic->xkb_file);
 	free(ic->xkb_layout);
 	free(ic->xkb_model);
@@ -361,8 +363,95 @@ void free_input_config(struct input_config *ic) {
 	free(ic);
 }
 
+static bool boxes_equal(const struct wlr_box *a, const struct wlr_box *b) {
+	return a->x == b->x && a->y == b->y &&
+		a->width == b->width && a->height == b->height;
+}
+
+static bool input_config_equal(const struct input_config *a,
+		const struct input_config *b) {
+	if (a->identifier != b->identifier ||
+			lenient_strcmp(a->input_type, b->input_type) != 0 ||
+			a->accel_profile != b->accel_profile ||
+			a->calibration_matrix.configured != b->calibration_matrix.configured ||
+			a->click_method != b->click_method ||
+			a->drag != b->drag ||
+			a->drag_lock != b->drag_lock ||
+			a->dwt != b->dwt ||
+			a->left_handed != b->left_handed ||
+			a->middle_emulation != b->middle_emulation ||
+			a->natural_scroll != b->natural_scroll ||
+			a->pointer_accel != b->pointer_accel ||
+			a->scroll_factor != b->scroll_factor ||
+			a->repeat_delay != b->repeat_delay ||
+			a->repeat_rate != b->repeat_rate ||
+			a->scroll_button != b->scroll_button ||
+			a->scroll_method != b->scroll_method ||
+			a->send_events != b->send_events ||
+			a->tap != b->tap ||
+			a->tap_button_map != b->tap_button_map ||
+			lenient_strcmp(a->xkb_layout, b->xkb_layout) != 0 ||
+			lenient_strcmp(a->xkb_model, b->xkb_model) != 0 ||
+			lenient_strcmp(a->xkb_options, b->xkb_options) != 0 ||
+			lenient_strcmp(a->xkb_rules, b->xkb_rules) != 0 ||
+			lenient_strcmp(a->xkb_variant, b->xkb_variant) != 0 ||
+			lenient_strcmp(a->xkb_file, b->xkb_file) != 0 ||
+			a->xkb_file_is_set != b->xkb_file_is_set ||
+			a->xkb_numlock != b->xkb_numlock ||
+			a->xkb_capslock != b->xkb_capslock ||
+			a->mapped_to != b->mapped_to ||
+			lenient_strcmp(a->mapped_to_output, b->mapped_to_output) != 0 ||
+			a->capturable != b->capturable ||
+			!boxes_equal(&a->region, &b->region)) {
+		return false;
+	}
+
+	// The keymap file may have been edited on disk since it was compiled
+	if (a->xkb_file) {
+		return false;
+	}
+
+	for (size_t i = 0; i < 6; ++i) {
+		if (a->calibration_matrix.matrix[i] != b->calibration_matrix.matrix[i]) {
+			return false;
+		}
+	}
+
+	const struct input_config_mapped_from_region *fa = a->mapped_from_region;
+	const struct input_config_mapped_from_region *fb = b->mapped_from_region;
+	if (!fa != !fb || (fa && (fa->x1 != fb->x1 || fa->y1 != fb->y1 ||
+			fa->x2 != fb->x2 || fa->y2 != fb->y2 || fa->mm != fb->mm))) {
+		return false;
+	}
+	if (!a->mapped_to_region != !b->mapped_to_region ||
+			(a->mapped_to_region &&
+			 !boxes_equal(a->mapped_to_region, b->mapped_to_region))) {
+		return false;
+	}
+	return true;
+}
+
+static bool input_config_lists_equal(list_t *a, list_t *b) {
+	if (a->length != b->length) {
+		return false;
+	}
+	for (int i = 0; i < a->length; ++i) {
+		if (!input_config_equal(a->items[i], b->items[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool input_configs_changed(struct sway_config *old_config) {
+	return !input_config_lists_equal(old_config->input_configs,
+			config->input_configs) ||
+		!input_config_lists_equal(old_config->input_type_configs,
+			config->input_type_configs);
+}
+
 int input_identifier_cmp(const void *item, const void *data) {
 	const struct input_config *ic = item;
 	const char *identifier = data;
-	return strcmp(ic->identifier, identifier);
+	return ic->identifier != identifier;
 }
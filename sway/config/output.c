@@ -13,6 +13,7 @@
 #include "sway/output.h"
 #include "sway/tree/root.h"
 #include "log.h"
+#include "stringop.h"
 #include "util.h"
 
 int output_name_cmp(const void *item, const void *data) {
@@ -641,15 +642,54 @@ void apply_output_config_to_outputs(struct output_config *oc) {
 	}
 }
 
-void reset_outputs(void) {
-	struct output_config *oc = NULL;
+static struct output_config *get_wildcard_output_config(void) {
 	int i = list_seq_find(config->output_configs, output_name_cmp, "*");
 	if (i >= 0) {
-		oc = config->output_configs->items[i];
-	} else {
-		oc = store_output_config(new_output_config("*"));
+		return config->output_configs->items[i];
+	}
+	return store_output_config(new_output_config("*"));
+}
+
+void reset_outputs(void) {
+	apply_output_config_to_outputs(get_wildcard_output_config());
+}
+
+static bool output_config_equal(const struct output_config *a,
+		const struct output_config *b) {
+	return strcmp(a->name, b->name) == 0 &&
+		a->enabled == b->enabled &&
+		a->width == b->width &&
+		a->height == b->height &&
+		a->refresh_rate == b->refresh_rate &&
+		a->custom_mode == b->custom_mode &&
+		a->x == b->x &&
+		a->y == b->y &&
+		a->scale == b->scale &&
+		a->scale_filter == b->scale_filter &&
+		a->transform == b->transform &&
+		a->subpixel == b->subpixel &&
+		a->max_render_time == b->max_render_time &&
+		a->adaptive_sync == b->adaptive_sync &&
+		lenient_strcmp(a->background, b->background) == 0 &&
+		lenient_strcmp(a->background_option, b->background_option) == 0 &&
+		lenient_strcmp(a->background_fallback, b->background_fallback) == 0 &&
+		a->dpms_state == b->dpms_state;
+}
+
+bool output_configs_changed(struct sway_config *old_config) {
+	// reset_outputs always leaves a wildcard config behind in the old config
+	get_wildcard_output_config();
+
+	list_t *old = old_config->output_configs, *new = config->output_configs;
+	if (old->length != new->length) {
+		return true;
+	}
+	for (int i = 0; i < old->length; ++i) {
+		if (!output_config_equal(old->items[i], new->items[i])) {
+			return true;
+		}
 	}
-	apply_output_config_to_outputs(oc);
+	return false;
 }
 
 void free_output_config(struct output_config *oc) {
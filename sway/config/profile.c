@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sway/config.h"
+#include "list.h"
+#include "log.h"
+
+struct config_profile *config_profile_create(void) {
+	struct config_profile *profile = calloc(1, sizeof(struct config_profile));
+	if (!profile) {
+		sway_log(SWAY_ERROR, "Unable to allocate config profile");
+		return NULL;
+	}
+	profile->files = create_list();
+	profile->handlers = create_list();
+	profile->phases = create_list();
+	return profile;
+}
+
+static void free_profile_entries(list_t *entries) {
+	if (!entries) {
+		return;
+	}
+	for (int i = 0; i < entries->length; ++i) {
+		struct config_profile_entry *entry = entries->items[i];
+		free(entry->name);
+		free(entry);
+	}
+	list_free(entries);
+}
+
+void config_profile_destroy(struct config_profile *profile) {
+	if (!profile) {
+		return;
+	}
+	free_profile_entries(profile->files);
+	free_profile_entries(profile->handlers);
+	free_profile_entries(profile->phases);
+	free(profile);
+}
+
+uint64_t config_profile_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void config_profile_add(struct config_profile *profile,
+		enum config_profile_kind kind, const char *name, uint64_t nsec) {
+	if (!profile) {
+		return;
+	}
+	list_t *entries = NULL;
+	switch (kind) {
+	case CONFIG_PROFILE_FILE:
+		entries = profile->files;
+		break;
+	case CONFIG_PROFILE_HANDLER:
+		entries = profile->handlers;
+		break;
+	case CONFIG_PROFILE_PHASE:
+		entries = profile->phases;
+		break;
+	}
+
+	struct config_profile_entry *entry = NULL;
+	for (int i = 0; i < entries->length; ++i) {
+		struct config_profile_entry *e = entries->items[i];
+		if (strcmp(e->name, name) == 0) {
+			entry = e;
+			break;
+		}
+	}
+	if (!entry) {
+		entry = calloc(1, sizeof(struct config_profile_entry));
+		if (!entry || !(entry->name = strdup(name))) {
+			free(entry);
+			return;
+		}
+		list_add(entries, entry);
+	}
+	++entry->count;
+	entry->nsec += nsec;
+}
+
+static int cmp_entry_time(const void *_a, const void *_b) {
+	const struct config_profile_entry *a = *(void **)_a;
+	const struct config_profile_entry *b = *(void **)_b;
+	return a->nsec < b->nsec ? 1 : a->nsec > b->nsec ? -1 : 0;
+}
+
+static void log_profile_entries(const char *title, list_t *entries) {
+	sway_log(SWAY_INFO, "Config profile, %s:", title);
+	for (int i = 0; i < entries->length; ++i) {
+		struct config_profile_entry *entry = entries->items[i];
+		sway_log(SWAY_INFO, "  %10.3f ms %6d  %s",
+				entry->nsec / 1000000.0, entry->count, entry->name);
+	}
+}
+
+void config_profile_log(struct config_profile *profile) {
+	if (!profile) {
+		return;
+	}
+	log_profile_entries("phases", profile->phases);
+	log_profile_entries("files (including nested includes)", profile->files);
+	list_stable_sort(profile->handlers, cmp_entry_time);
+	log_profile_entries("command handlers", profile->handlers);
+}
@@ -3,7 +3,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include "sway/config.h"
+#include "intern.h"
 #include "log.h"
+#include "stringop.h"
 
 struct seat_config *new_seat_config(const char* name) {
 	struct seat_config *seat = calloc(1, sizeof(struct seat_config));
@@ -96,7 +98,6 @@ struct seat_attachment_config *seat_attachment_config_new(void) {
 
 static void seat_attachment_config_free(
 		struct seat_attachment_config *attachment) {
-	free(attachment->identifier);
 	free(attachment);
 	return;
 }
@@ -108,7 +109,7 @@ static struct seat_attachment_config *seat_attachment_config_copy(
 		return NULL;
 	}
 
-	copy->identifier = strdup(attachment->identifier);
+	copy->identifier = attachment->identifier;
 
 	return copy;
 }
@@ -130,8 +131,8 @@ void merge_seat_config(struct seat_config *dest, struct seat_config *source) {
 		for (int j = 0; j < dest->attachments->length; ++j) {
 			struct seat_attachment_config *dest_attachment =
 				dest->attachments->items[j];
-			if (strcmp(source_attachment->identifier,
-						dest_attachment->identifier) == 0) {
+			if (source_attachment->identifier ==
+					dest_attachment->identifier) {
 				merge_seat_attachment_config(dest_attachment,
 					source_attachment);
 				found = true;
@@ -210,14 +211,52 @@ int seat_name_cmp(const void *item, const void *data) {
 }
 
 struct seat_attachment_config *seat_config_get_attachment(
-		struct seat_config *seat_config, char *identifier) {
+		struct seat_config *seat_config, const char *identifier) {
 	for (int i = 0; i < seat_config->attachments->length; ++i) {
 		struct seat_attachment_config *attachment =
 			seat_config->attachments->items[i];
-		if (strcmp(attachment->identifier, identifier) == 0) {
+		if (attachment->identifier == identifier) {
 			return attachment;
 		}
 	}
 
 	return NULL;
 }
+
+static bool seat_config_equal(const struct seat_config *a,
+		const struct seat_config *b) {
+	if (strcmp(a->name, b->name) != 0 ||
+			a->fallback != b->fallback ||
+			a->hide_cursor_timeout != b->hide_cursor_timeout ||
+			a->allow_constrain != b->allow_constrain ||
+			a->shortcuts_inhibit != b->shortcuts_inhibit ||
+			a->keyboard_grouping != b->keyboard_grouping ||
+			a->idle_inhibit_sources != b->idle_inhibit_sources ||
+			a->idle_wake_sources != b->idle_wake_sources ||
+			lenient_strcmp(a->xcursor_theme.name, b->xcursor_theme.name) != 0 ||
+			a->xcursor_theme.size != b->xcursor_theme.size ||
+			a->attachments->length != b->attachments->length) {
+		return false;
+	}
+	for (int i = 0; i < a->attachments->length; ++i) {
+		struct seat_attachment_config *aa = a->attachments->items[i];
+		struct seat_attachment_config *ba = b->attachments->items[i];
+		if (aa->identifier != ba->identifier) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool seat_configs_changed(struct sway_config *old_config) {
+	list_t *old = old_config->seat_configs, *new = config->seat_configs;
+	if (old->length != new->length) {
+		return true;
+	}
+	for (int i = 0; i < old->length; ++i) {
+		if (!seat_config_equal(old->items[i], new->items[i])) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <strings.h>
 #include <pcre.h>
+#include "sway/commands.h"
 #include "sway/criteria.h"
 #include "sway/tree/container.h"
 #include "sway/config.h"
@@ -21,6 +22,7 @@ bool criteria_is_empty(struct criteria *criteria) {
 		&& !criteria->app_id
 		&& !criteria->con_mark
 		&& !criteria->con_id
+		&& !criteria->con_id_focused
 #if HAVE_XWAYLAND
 		&& !criteria->class
 		&& !criteria->id
@@ -95,6 +97,7 @@ void criteria_destroy(struct criteria *criteria) {
 	pattern_destroy(criteria->con_mark);
 	free(criteria->workspace);
 	free(criteria->cmdlist);
+	cmd_list_destroy(criteria->compiled_cmdlist);
 	free(criteria->raw);
 	free(criteria);
 }
@@ -146,7 +149,7 @@ static void find_urgent_iterator(struct sway_container *con, void *data) {
 }
 
 static bool has_container_criteria(struct criteria *criteria) {
-	return criteria->con_mark || criteria->con_id;
+	return criteria->con_mark || criteria->con_id || criteria->con_id_focused;
 }
 
 static bool criteria_matches_container(struct criteria *criteria,
@@ -171,6 +174,14 @@ static bool criteria_matches_container(struct criteria *criteria,
 		}
 	}
 
+	if (criteria->con_id_focused) {
+		struct sway_seat *seat = input_manager_current_seat();
+		struct sway_container *focus = seat_get_focused_container(seat);
+		if (!focus || !focus->view || container != focus) {
+			return false;
+		}
+	}
+
 	return true;
 }
 
@@ -539,10 +550,7 @@ static bool parse_token(struct criteria *criteria, char *name, char *value) {
 		break;
 	case T_CON_ID:
 		if (strcmp(value, "__focused__") == 0) {
-			struct sway_seat *seat = input_manager_current_seat();
-			struct sway_container *focus = seat_get_focused_container(seat);
-			struct sway_view *view = focus ? focus->view : NULL;
-			criteria->con_id = view ? view->container->node.id : 0;
+			criteria->con_id_focused = true;
 		} else {
 			criteria->con_id = strtoul(value, &endptr, 10);
 			if (*endptr != 0) {
@@ -20,6 +20,13 @@ void desktop_damage_whole_container(struct sway_container *con) {
 	}
 }
 
+void desktop_damage_container_decorations(struct sway_container *con) {
+	for (int i = 0; i < root->outputs->length; ++i) {
+		struct sway_output *output = root->outputs->items[i];
+		output_damage_container_decorations(output, con);
+	}
+}
+
 void desktop_damage_box(struct wlr_box *box) {
 	for (int i = 0; i < root->outputs->length; ++i) {
 		struct sway_output *output = root->outputs->items[i];
@@ -1,5 +1,6 @@
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 #include <strings.h>
 #include <time.h>
@@ -782,6 +783,77 @@ void output_damage_whole_container(struct sway_output *output,
 	}
 }
 
+// Expecting an unpadded box in layout coordinates
+static void damage_layout_rect(struct sway_output *output,
+		double x, double y, double width, double height) {
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	// Pad the box by 1px, because the geometry is in doubles
+	struct wlr_box box = {
+		.x = floor(x) - output->lx - 1,
+		.y = floor(y) - output->ly - 1,
+		.width = ceil(width) + 2,
+		.height = ceil(height) + 2,
+	};
+	scale_box(&box, output->wlr_output->scale);
+	wlr_output_damage_add_box(output->damage, &box);
+}
+
+static void damage_view_decorations(struct sway_output *output,
+		struct sway_container *con) {
+	struct sway_container_state *state = &con->current;
+	double content_bottom = state->content_y + state->content_height;
+	double content_right = state->content_x + state->content_width;
+	// Titlebar (or tab/stack header) and top border
+	damage_layout_rect(output, state->x, state->y,
+			state->width, state->content_y - state->y);
+	// Bottom border
+	damage_layout_rect(output, state->x, content_bottom,
+			state->width, state->y + state->height - content_bottom);
+	// Left and right borders
+	damage_layout_rect(output, state->x, state->content_y,
+			state->content_x - state->x, state->content_height);
+	damage_layout_rect(output, content_right, state->content_y,
+			state->x + state->width - content_right, state->content_height);
+}
+
+static void damage_container_decorations(struct sway_output *output,
+		struct sway_container *con) {
+	if (con->view) {
+		damage_view_decorations(output, con);
+		return;
+	}
+	// A split container's own title is drawn in its parent's tab or stack
+	// header, directly above the container
+	if (con->current.workspace) {
+		enum sway_container_layout layout =
+			container_current_parent_layout(con);
+		size_t header = 0;
+		if (layout == L_TABBED) {
+			header = container_titlebar_height();
+		} else if (layout == L_STACKED) {
+			list_t *siblings = con->current.parent ?
+				con->current.parent->current.children :
+				con->current.workspace->current.tiling;
+			header = container_titlebar_height() * siblings->length;
+		}
+		damage_layout_rect(output, con->current.x, con->current.y - header,
+				con->current.width, header);
+	}
+	// The colors of the descendants' decorations depend on this container's
+	// focus
+	list_t *children = con->current.children;
+	for (int i = 0; children && i < children->length; ++i) {
+		damage_container_decorations(output, children->items[i]);
+	}
+}
+
+void output_damage_container_decorations(struct sway_output *output,
+		struct sway_container *con) {
+	damage_container_decorations(output, con);
+}
+
 static void damage_handle_destroy(struct wl_listener *listener, void *data) {
 	struct sway_output *output =
 		wl_container_of(listener, output, damage_destroy);
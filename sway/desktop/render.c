@@ -1,7 +1,9 @@
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
 #include <GLES2/gl2.h>
+#include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <time.h>
 #include <wayland-server-core.h>
@@ -96,6 +98,118 @@ static void set_scale_filter(struct wlr_output *wlr_output,
 	}
 }
 
+struct batched_rect {
+	struct wlr_box box; // output-buffer-local
+	float color[4];
+};
+
+/**
+ * Solid rects rendered while the batch is active for an output are collected
+ * instead of drawn, then drawn grouped by color when the batch is flushed.
+ * The batch has to be flushed before anything is drawn which could overlap
+ * the rects, so it's flushed before every texture and before floating
+ * containers and seat operations.
+ */
+static struct {
+	struct sway_output *output;
+	pixman_region32_t *damage;
+	struct batched_rect *rects;
+	size_t length, capacity;
+} rect_batch;
+
+static void rect_batch_begin(struct sway_output *output,
+		pixman_region32_t *damage) {
+	rect_batch.output = output;
+	rect_batch.damage = damage;
+	rect_batch.length = 0;
+}
+
+static int batched_rect_cmp(const void *_a, const void *_b) {
+	const struct batched_rect *a = _a;
+	const struct batched_rect *b = _b;
+	return memcmp(a->color, b->color, sizeof(a->color));
+}
+
+static void rect_batch_flush(void) {
+	if (!rect_batch.length) {
+		return;
+	}
+	struct sway_output *output = rect_batch.output;
+	struct wlr_output *wlr_output = output->wlr_output;
+	struct wlr_renderer *renderer =
+		wlr_backend_get_renderer(wlr_output->backend);
+
+	qsort(rect_batch.rects, rect_batch.length, sizeof(struct batched_rect),
+			batched_rect_cmp);
+
+	// The rects are clipped to the damage, so no scissoring is needed
+	wlr_renderer_scissor(renderer, NULL);
+
+	size_t start = 0;
+	while (start < rect_batch.length) {
+		struct batched_rect *first = &rect_batch.rects[start];
+		size_t end = start + 1;
+		while (end < rect_batch.length &&
+				batched_rect_cmp(first, &rect_batch.rects[end]) == 0) {
+			++end;
+		}
+
+		pixman_region32_t region;
+		pixman_region32_init(&region);
+		for (size_t i = start; i < end; ++i) {
+			struct wlr_box *box = &rect_batch.rects[i].box;
+			pixman_region32_union_rect(&region, &region,
+					box->x, box->y, box->width, box->height);
+		}
+		pixman_region32_intersect(&region, &region, rect_batch.damage);
+
+		int nrects;
+		pixman_box32_t *rects = pixman_region32_rectangles(&region, &nrects);
+		for (int i = 0; i < nrects; ++i) {
+			struct wlr_box box = {
+				.x = rects[i].x1,
+				.y = rects[i].y1,
+				.width = rects[i].x2 - rects[i].x1,
+				.height = rects[i].y2 - rects[i].y1,
+			};
+			wlr_render_rect(renderer, &box, first->color,
+				wlr_output->transform_matrix);
+			output->render_stats.draws++;
+		}
+		pixman_region32_fini(&region);
+		start = end;
+	}
+	rect_batch.length = 0;
+}
+
+static void rect_batch_end(void) {
+	rect_batch_flush();
+	rect_batch.output = NULL;
+	rect_batch.damage = NULL;
+}
+
+static bool rect_batch_add(struct sway_output *output,
+		const struct wlr_box *box, const float color[static 4]) {
+	if (rect_batch.output != output) {
+		return false;
+	}
+	if (rect_batch.length == rect_batch.capacity) {
+		size_t capacity = rect_batch.capacity ? rect_batch.capacity * 2 : 64;
+		struct batched_rect *rects = realloc(rect_batch.rects,
+				capacity * sizeof(struct batched_rect));
+		if (!rects) {
+			// Draw it directly instead
+			return false;
+		}
+		rect_batch.rects = rects;
+		rect_batch.capacity = capacity;
+	}
+	struct batched_rect *rect = &rect_batch.rects[rect_batch.length++];
+	rect->box = *box;
+	memcpy(rect->color, color, sizeof(rect->color));
+	return true;
+}
+
 static void render_texture(struct wlr_output *wlr_output,
 		pixman_region32_t *output_damage, struct wlr_texture *texture,
 		const struct wlr_fbox *src_box, const struct wlr_box *dst_box,
@@ -107,6 +221,9 @@ static void render_texture(struct wlr_output *wlr_output,
 	struct wlr_gles2_texture_attribs attribs;
 	wlr_gles2_texture_get_attribs(texture, &attribs);
 
+	// Rects drawn so far may be underneath the texture
+	rect_batch_flush();
+
 	pixman_region32_t damage;
 	pixman_region32_init(&damage);
 	pixman_region32_union_rect(&damage, &damage, dst_box->x, dst_box->y,
@@ -122,6 +239,7 @@ static void render_texture(struct wlr_output *wlr_output,
 	for (int i = 0; i < nrects; ++i) {
 		scissor_output(wlr_output, &rects[i]);
 		set_scale_filter(wlr_output, texture, output->scale_filter);
+		output->render_stats.draws++;
 		if (src_box != NULL) {
 			wlr_render_subtexture_with_matrix(renderer, texture, src_box, matrix, alpha);
 		} else {
@@ -221,6 +339,14 @@ void render_rect(struct sway_output *output,
 	box.x -= output->lx * wlr_output->scale;
 	box.y -= output->ly * wlr_output->scale;
 
+	if (box.width <= 0 || box.height <= 0) {
+		return;
+	}
+	if (output_damage == rect_batch.damage &&
+			rect_batch_add(output, &box, color)) {
+		return;
+	}
+
 	pixman_region32_t damage;
 	pixman_region32_init(&damage);
 	pixman_region32_union_rect(&damage, &damage, box.x, box.y,
@@ -237,6 +363,7 @@ void render_rect(struct sway_output *output,
 		scissor_output(wlr_output, &rects[i]);
 		wlr_render_rect(renderer, &box, color,
 			wlr_output->transform_matrix);
+		output->render_stats.draws++;
 	}
 
 damage_finish:
@@ -401,6 +528,29 @@ static void render_view(struct sway_output *output, pixman_region32_t *damage,
 	}
 }
 
+/**
+ * Return true if any part of the box, in layout coordinates, is in the output
+ * damage. Used to skip decorations before doing any work for them.
+ */
+static bool box_is_damaged(struct sway_output *output,
+		pixman_region32_t *output_damage, const struct wlr_box *_box) {
+	struct wlr_box box = {
+		.x = _box->x - output->lx,
+		.y = _box->y - output->ly,
+		.width = _box->width,
+		.height = _box->height,
+	};
+	scale_box(&box, output->wlr_output->scale);
+	pixman_box32_t rect = {
+		.x1 = box.x,
+		.y1 = box.y,
+		.x2 = box.x + box.width,
+		.y2 = box.y + box.height,
+	};
+	return pixman_region32_contains_rectangle(output_damage, &rect) !=
+		PIXMAN_REGION_OUT;
+}
+
 /**
  * Render a titlebar.
  *
@@ -425,6 +575,16 @@ static void render_titlebar(struct sway_output *output,
 	int titlebar_v_padding = config->titlebar_v_padding;
 	enum alignment title_align = config->title_align;
 
+	struct wlr_box titlebar_box = {
+		.x = x,
+		.y = y,
+		.width = width,
+		.height = container_titlebar_height(),
+	};
+	if (!box_is_damaged(output, output_damage, &titlebar_box)) {
+		return;
+	}
+
 	// Single pixel bar above title
 	memcpy(&color, colors->border, sizeof(float) * 4);
 	premultiply_alpha(color, con->alpha);
@@ -689,6 +849,34 @@ struct parent_data {
 static void render_container(struct sway_output *output,
 	pixman_region32_t *damage, struct sway_container *con, bool parent_focused);
 
+/**
+ * Pick the border colors and title and marks textures for a child of the
+ * given parent.
+ */
+static struct border_colors *child_colors(struct sway_container *child,
+		struct parent_data *parent, struct wlr_texture **title_texture,
+		struct wlr_texture **marks_texture) {
+	bool urgent = child->view ?
+		view_is_urgent(child->view) : container_has_urgent_child(child);
+
+	if (urgent) {
+		*title_texture = child->title_urgent;
+		*marks_texture = child->marks_urgent;
+		return &config->border_colors.urgent;
+	} else if (child->current.focused || parent->focused) {
+		*title_texture = child->title_focused;
+		*marks_texture = child->marks_focused;
+		return &config->border_colors.focused;
+	} else if (child == parent->active_child) {
+		*title_texture = child->title_focused_inactive;
+		*marks_texture = child->marks_focused_inactive;
+		return &config->border_colors.focused_inactive;
+	}
+	*title_texture = child->title_unfocused;
+	*marks_texture = child->marks_unfocused;
+	return &config->border_colors.unfocused;
+}
+
 /**
  * Render a container's children using a L_HORIZ or L_VERT layout.
  *
@@ -701,29 +889,11 @@ static void render_containers_linear(struct sway_output *output,
 		struct sway_container *child = parent->children->items[i];
 
 		if (child->view) {
-			struct sway_view *view = child->view;
-			struct border_colors *colors;
 			struct wlr_texture *title_texture;
 			struct wlr_texture *marks_texture;
 			struct sway_container_state *state = &child->current;
-
-			if (view_is_urgent(view)) {
-				colors = &config->border_colors.urgent;
-				title_texture = child->title_urgent;
-				marks_texture = child->marks_urgent;
-			} else if (state->focused || parent->focused) {
-				colors = &config->border_colors.focused;
-				title_texture = child->title_focused;
-				marks_texture = child->marks_focused;
-			} else if (child == parent->active_child) {
-				colors = &config->border_colors.focused_inactive;
-				title_texture = child->title_focused_inactive;
-				marks_texture = child->marks_focused_inactive;
-			} else {
-				colors = &config->border_colors.unfocused;
-				title_texture = child->title_unfocused;
-				marks_texture = child->marks_unfocused;
-			}
+			struct border_colors *colors = child_colors(child, parent,
+					&title_texture, &marks_texture);
 
 			if (state->border == B_NORMAL) {
 				render_titlebar(output, damage, child, state->x,
@@ -749,50 +919,43 @@ static void render_containers_tabbed(struct sway_output *output,
 		return;
 	}
 	struct sway_container *current = parent->active_child;
-	struct border_colors *current_colors = &config->border_colors.unfocused;
+	struct wlr_texture *title_texture;
+	struct wlr_texture *marks_texture;
+	struct border_colors *current_colors =
+		child_colors(current, parent, &title_texture, &marks_texture);
 	int tab_width = parent->box.width / parent->children->length;
 
-	// Render tabs
-	for (int i = 0; i < parent->children->length; ++i) {
-		struct sway_container *child = parent->children->items[i];
-		struct sway_view *view = child->view;
-		struct sway_container_state *cstate = &child->current;
-		struct border_colors *colors;
-		struct wlr_texture *title_texture;
-		struct wlr_texture *marks_texture;
-		bool urgent = view ?
-			view_is_urgent(view) : container_has_urgent_child(child);
-
-		if (urgent) {
-			colors = &config->border_colors.urgent;
-			title_texture = child->title_urgent;
-			marks_texture = child->marks_urgent;
-		} else if (cstate->focused || parent->focused) {
-			colors = &config->border_colors.focused;
-			title_texture = child->title_focused;
-			marks_texture = child->marks_focused;
-		} else if (child == parent->active_child) {
-			colors = &config->border_colors.focused_inactive;
-			title_texture = child->title_focused_inactive;
-			marks_texture = child->marks_focused_inactive;
-		} else {
-			colors = &config->border_colors.unfocused;
-			title_texture = child->title_unfocused;
-			marks_texture = child->marks_unfocused;
-		}
-
-		int x = cstate->x + tab_width * i;
-
-		// Make last tab use the remaining width of the parent
-		if (i == parent->children->length - 1) {
-			tab_width = parent->box.width - tab_width * i;
-		}
-
-		render_titlebar(output, damage, child, x, parent->box.y, tab_width,
-				colors, title_texture, marks_texture);
+	// Render tabs, unless none of the tab bar is damaged
+	struct wlr_box tabs_box = {
+		.x = parent->box.x,
+		.y = parent->box.y,
+		.width = parent->box.width,
+		.height = container_titlebar_height(),
+	};
+	if (box_is_damaged(output, damage, &tabs_box)) {
+		for (int i = 0; i < parent->children->length; ++i) {
+			struct sway_container *child = parent->children->items[i];
+			struct sway_container_state *cstate = &child->current;
+			int x = cstate->x + tab_width * i;
+
+			// Make last tab use the remaining width of the parent
+			if (i == parent->children->length - 1) {
+				tab_width = parent->box.width - tab_width * i;
+			}
 
-		if (child == current) {
-			current_colors = colors;
+			struct wlr_box tab_box = {
+				.x = x,
+				.y = parent->box.y,
+				.width = tab_width,
+				.height = tabs_box.height,
+			};
+			if (!box_is_damaged(output, damage, &tab_box)) {
+				continue;
+			}
+			struct border_colors *colors = child_colors(child, parent,
+					&title_texture, &marks_texture);
+			render_titlebar(output, damage, child, x, parent->box.y, tab_width,
+					colors, title_texture, marks_texture);
 		}
 	}
 
@@ -814,44 +977,36 @@ static void render_containers_stacked(struct sway_output *output,
 		return;
 	}
 	struct sway_container *current = parent->active_child;
-	struct border_colors *current_colors = &config->border_colors.unfocused;
+	struct wlr_texture *title_texture;
+	struct wlr_texture *marks_texture;
+	struct border_colors *current_colors =
+		child_colors(current, parent, &title_texture, &marks_texture);
 	size_t titlebar_height = container_titlebar_height();
 
-	// Render titles
-	for (int i = 0; i < parent->children->length; ++i) {
-		struct sway_container *child = parent->children->items[i];
-		struct sway_view *view = child->view;
-		struct sway_container_state *cstate = &child->current;
-		struct border_colors *colors;
-		struct wlr_texture *title_texture;
-		struct wlr_texture *marks_texture;
-		bool urgent = view ?
-			view_is_urgent(view) : container_has_urgent_child(child);
-
-		if (urgent) {
-			colors = &config->border_colors.urgent;
-			title_texture = child->title_urgent;
-			marks_texture = child->marks_urgent;
-		} else if (cstate->focused || parent->focused) {
-			colors = &config->border_colors.focused;
-			title_texture = child->title_focused;
-			marks_texture = child->marks_focused;
-		} else if (child == parent->active_child) {
-			colors = &config->border_colors.focused_inactive;
-			title_texture = child->title_focused_inactive;
-			marks_texture = child->marks_focused_inactive;
-		} else {
-			colors = &config->border_colors.unfocused;
-			title_texture = child->title_unfocused;
-			marks_texture = child->marks_unfocused;
-		}
-
-		int y = parent->box.y + titlebar_height * i;
-		render_titlebar(output, damage, child, parent->box.x, y,
-				parent->box.width, colors, title_texture, marks_texture);
-
-		if (child == current) {
-			current_colors = colors;
+	// Render titles, unless none of the stack is damaged
+	struct wlr_box stack_box = {
+		.x = parent->box.x,
+		.y = parent->box.y,
+		.width = parent->box.width,
+		.height = titlebar_height * parent->children->length,
+	};
+	if (box_is_damaged(output, damage, &stack_box)) {
+		for (int i = 0; i < parent->children->length; ++i) {
+			struct sway_container *child = parent->children->items[i];
+			int y = parent->box.y + titlebar_height * i;
+			struct wlr_box title_box = {
+				.x = parent->box.x,
+				.y = y,
+				.width = parent->box.width,
+				.height = titlebar_height,
+			};
+			if (!box_is_damaged(output, damage, &title_box)) {
+				continue;
+			}
+			struct border_colors *colors = child_colors(child, parent,
+					&title_texture, &marks_texture);
+			render_titlebar(output, damage, child, parent->box.x, y,
+					parent->box.width, colors, title_texture, marks_texture);
 		}
 	}
 
@@ -925,6 +1080,8 @@ static void render_workspace(struct sway_output *output,
 
 static void render_floating_container(struct sway_output *soutput,
 		pixman_region32_t *damage, struct sway_container *con) {
+	// Floating containers may overlap anything drawn before them
+	rect_batch_flush();
 	if (con->view) {
 		struct sway_view *view = con->view;
 		struct border_colors *colors;
@@ -980,15 +1137,48 @@ static void render_floating(struct sway_output *soutput,
 
 static void render_seatops(struct sway_output *output,
 		pixman_region32_t *damage) {
+	rect_batch_flush();
 	struct sway_seat *seat;
 	wl_list_for_each(seat, &server.input->seats, link) {
 		seatop_render(seat, output, damage);
 	}
 }
 
+static void render_stats_update(struct sway_output *output,
+		struct timespec *start) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	output->render_stats.frames++;
+	output->render_stats.render_nsec +=
+		(now.tv_sec - start->tv_sec) * 1000000000 +
+		(now.tv_nsec - start->tv_nsec);
+
+	struct timespec *since = &output->render_stats.since;
+	if (since->tv_sec == 0) {
+		*since = now;
+		return;
+	}
+	if (now.tv_sec - since->tv_sec < 5) {
+		return;
+	}
+	uint64_t frames = output->render_stats.frames;
+	sway_log(SWAY_INFO, "Render stats for %s: %" PRIu64 " frames, "
+			"%.3fms per frame, %.1f draws per frame, %" PRIu64
+			" texture uploads", output->wlr_output->name, frames,
+			output->render_stats.render_nsec / 1000000.0 / frames,
+			(double)output->render_stats.draws / frames,
+			output->render_stats.texture_uploads);
+	memset(&output->render_stats, 0, sizeof(output->render_stats));
+	output->render_stats.since = now;
+}
+
 void output_render(struct sway_output *output, struct timespec *when,
 		pixman_region32_t *damage) {
 	struct wlr_output *wlr_output = output->wlr_output;
+	struct timespec render_start;
+	if (debug.render_stats) {
+		clock_gettime(CLOCK_MONOTONIC, &render_start);
+	}
 
 	struct wlr_renderer *renderer =
 		wlr_backend_get_renderer(wlr_output->backend);
@@ -1022,6 +1212,8 @@ void output_render(struct sway_output *output, struct timespec *when,
 		pixman_region32_union_rect(damage, damage, 0, 0, width, height);
 	}
 
+	rect_batch_begin(output, damage);
+
 	if (output_has_opaque_overlay_layer_surface(output)) {
 		goto render_overlay;
 	}
@@ -1034,6 +1226,7 @@ void output_render(struct sway_output *output, struct timespec *when,
 		for (int i = 0; i < nrects; ++i) {
 			scissor_output(wlr_output, &rects[i]);
 			wlr_renderer_clear(renderer, clear_color);
+			output->render_stats.draws++;
 		}
 
 		if (fullscreen_con->view) {
@@ -1066,6 +1259,7 @@ void output_render(struct sway_output *output, struct timespec *when,
 		for (int i = 0; i < nrects; ++i) {
 			scissor_output(wlr_output, &rects[i]);
 			wlr_renderer_clear(renderer, clear_color);
+			output->render_stats.draws++;
 		}
 
 		render_layer_toplevel(output, damage,
@@ -1105,6 +1299,7 @@ render_overlay:
 	render_drag_icons(output, damage, &root->drag_icons);
 
 renderer_end:
+	rect_batch_end();
 	wlr_renderer_scissor(renderer, NULL);
 	wlr_output_render_software_cursors(wlr_output, damage);
 	wlr_renderer_end(renderer);
@@ -1132,4 +1327,8 @@ renderer_end:
 		return;
 	}
 	output->last_frame = *when;
+
+	if (debug.render_stats) {
+		render_stats_update(output, &render_start);
+	}
 }
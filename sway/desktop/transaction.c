@@ -24,6 +24,7 @@ struct sway_transaction {
 	size_t num_waiting;
 	size_t num_configures;
 	struct timespec commit_time;
+	bool partial; // Output groups may be applied before the whole transaction
 };
 
 struct sway_transaction_instruction {
@@ -35,6 +36,9 @@ struct sway_transaction_instruction {
 		struct sway_container_state container_state;
 	};
 	uint32_t serial;
+	struct sway_output *output; // Group for partial applies, may be NULL
+	bool waiting;               // Configured and not yet acked by the view
+	bool applied;
 };
 
 static struct sway_transaction *transaction_create(void) {
@@ -83,6 +87,24 @@ static void transaction_destroy(struct sway_transaction *transaction) {
 	free(transaction);
 }
 
+// The direct tiling child of the workspace which has inactive focus
+static struct sway_container *workspace_focused_inactive_child(
+		struct sway_seat *seat, struct sway_workspace *ws) {
+	struct sway_container *focus = seat_get_focus_inactive_tiling(seat, ws);
+	if (focus) {
+		while (focus->parent) {
+			focus = focus->parent;
+		}
+	}
+	return focus;
+}
+
+static struct sway_container *container_focused_inactive_child(
+		struct sway_seat *seat, struct sway_container *con) {
+	struct sway_node *focus = seat_get_active_tiling_child(seat, &con->node);
+	return focus ? focus->sway_container : NULL;
+}
+
 static void copy_output_state(struct sway_output *output,
 		struct sway_transaction_instruction *instruction) {
 	struct sway_output_state *state = &instruction->output_state;
@@ -111,15 +133,8 @@ static void copy_workspace_state(struct sway_workspace *ws,
 
 	struct sway_seat *seat = input_manager_current_seat();
 	state->focused = seat_get_focus(seat) == &ws->node;
-
-	// Set focused_inactive_child to the direct tiling child
-	struct sway_container *focus = seat_get_focus_inactive_tiling(seat, ws);
-	if (focus) {
-		while (focus->parent) {
-			focus = focus->parent;
-		}
-	}
-	state->focused_inactive_child = focus;
+	state->focused_inactive_child =
+		workspace_focused_inactive_child(seat, ws);
 }
 
 static void copy_container_state(struct sway_container *container,
@@ -154,12 +169,58 @@ static void copy_container_state(struct sway_container *container,
 	state->focused = seat_get_focus(seat) == &container->node;
 
 	if (!container->view) {
-		struct sway_node *focus =
-			seat_get_active_tiling_child(seat, &container->node);
-		state->focused_inactive_child = focus ? focus->sway_container : NULL;
+		state->focused_inactive_child =
+			container_focused_inactive_child(seat, container);
 	}
 }
 
+/**
+ * Return true if the node's pending state differs from its current state, or
+ * might do so because the node is still part of a queued transaction. Nodes
+ * which haven't changed don't need an instruction.
+ */
+static bool node_state_changed(struct sway_node *node) {
+	if (node->destroying || node->ntxnrefs > 0) {
+		return true;
+	}
+	struct sway_seat *seat = input_manager_current_seat();
+	switch (node->type) {
+	case N_ROOT:
+		return true;
+	case N_OUTPUT:;
+		struct sway_output *output = node->sway_output;
+		return output_get_active_workspace(output) !=
+			output->current.active_workspace ||
+			!list_equal(output->workspaces, output->current.workspaces);
+	case N_WORKSPACE:;
+		struct sway_workspace *ws = node->sway_workspace;
+		struct sway_workspace_state *wstate = &ws->current;
+		if (!wstate->tiling || !wstate->floating) {
+			return true;
+		}
+		return ws->fullscreen != wstate->fullscreen ||
+			ws->x != wstate->x || ws->y != wstate->y ||
+			ws->width != wstate->width || ws->height != wstate->height ||
+			ws->layout != wstate->layout || ws->output != wstate->output ||
+			!list_equal(ws->tiling, wstate->tiling) ||
+			!list_equal(ws->floating, wstate->floating) ||
+			(seat_get_focus(seat) == node) != wstate->focused ||
+			workspace_focused_inactive_child(seat, ws) !=
+				wstate->focused_inactive_child;
+	case N_CONTAINER:;
+		struct sway_container *con = node->sway_container;
+		if (container_state_changed(con)) {
+			return true;
+		}
+		if ((seat_get_focus(seat) == node) != con->current.focused) {
+			return true;
+		}
+		return !con->view && container_focused_inactive_child(seat, con) !=
+			con->current.focused_inactive_child;
+	}
+	return true;
+}
+
 static void transaction_add_node(struct sway_transaction *transaction,
 		struct sway_node *node) {
 	struct sway_transaction_instruction *instruction =
@@ -205,9 +266,65 @@ static void apply_workspace_state(struct sway_workspace *ws,
 	output_damage_whole(ws->current.output);
 }
 
+static bool container_is_tab_or_stack(struct sway_container_state *state) {
+	enum sway_container_layout layout;
+	if (state->parent) {
+		layout = state->parent->current.layout;
+	} else if (state->workspace) {
+		layout = state->workspace->current.layout;
+	} else {
+		return false;
+	}
+	return layout == L_TABBED || layout == L_STACKED;
+}
+
+/**
+ * Return true if the two states only differ in focus, which only changes the
+ * colors of the container's decorations.
+ *
+ * In tabbed and stacked containers focus also decides which child is visible,
+ * so a change of the focused tab needs the whole container redrawn.
+ */
+static bool container_state_only_focus_changed(struct sway_container_state *a,
+		struct sway_container_state *b) {
+	bool tabs = b->layout == L_TABBED || b->layout == L_STACKED;
+	if ((tabs && a->focused_inactive_child != b->focused_inactive_child) ||
+			(a->focused != b->focused && container_is_tab_or_stack(b))) {
+		return false;
+	}
+	if (a->layout != b->layout || a->x != b->x || a->y != b->y ||
+			a->width != b->width || a->height != b->height ||
+			a->fullscreen_mode != b->fullscreen_mode ||
+			a->workspace != b->workspace || a->parent != b->parent ||
+			a->border != b->border ||
+			a->border_thickness != b->border_thickness ||
+			a->border_top != b->border_top ||
+			a->border_bottom != b->border_bottom ||
+			a->border_left != b->border_left ||
+			a->border_right != b->border_right ||
+			a->content_x != b->content_x || a->content_y != b->content_y ||
+			a->content_width != b->content_width ||
+			a->content_height != b->content_height) {
+		return false;
+	}
+	if (!a->children || !b->children) {
+		return a->children == b->children;
+	}
+	return list_equal(a->children, b->children);
+}
+
 static void apply_container_state(struct sway_container *container,
 		struct sway_container_state *state) {
 	struct sway_view *view = container->view;
+	if (!container->node.destroying &&
+			(!view || wl_list_empty(&view->saved_buffers)) &&
+			container_state_only_focus_changed(&container->current, state)) {
+		list_free(container->current.children);
+		memcpy(&container->current, state, sizeof(struct sway_container_state));
+		desktop_damage_container_decorations(container);
+		return;
+	}
+
 	// Damage the old location
 	desktop_damage_whole_container(container);
 	if (view && !wl_list_empty(&view->saved_buffers)) {
@@ -274,6 +391,29 @@ static void apply_container_state(struct sway_container *container,
 	}
 }
 
+static void apply_instruction(struct sway_transaction_instruction *instruction) {
+	struct sway_node *node = instruction->node;
+
+	switch (node->type) {
+	case N_ROOT:
+		break;
+	case N_OUTPUT:
+		apply_output_state(node->sway_output, &instruction->output_state);
+		break;
+	case N_WORKSPACE:
+		apply_workspace_state(node->sway_workspace,
+				&instruction->workspace_state);
+		break;
+	case N_CONTAINER:
+		apply_container_state(node->sway_container,
+				&instruction->container_state);
+		break;
+	}
+
+	instruction->applied = true;
+	node->instruction = NULL;
+}
+
 /**
  * Apply a transaction to the "current" state of the tree.
  */
@@ -293,25 +433,9 @@ static void transaction_apply(struct sway_transaction *transaction) {
 	for (int i = 0; i < transaction->instructions->length; ++i) {
 		struct sway_transaction_instruction *instruction =
 			transaction->instructions->items[i];
-		struct sway_node *node = instruction->node;
-
-		switch (node->type) {
-		case N_ROOT:
-			break;
-		case N_OUTPUT:
-			apply_output_state(node->sway_output, &instruction->output_state);
-			break;
-		case N_WORKSPACE:
-			apply_workspace_state(node->sway_workspace,
-					&instruction->workspace_state);
-			break;
-		case N_CONTAINER:
-			apply_container_state(node->sway_container,
-					&instruction->container_state);
-			break;
+		if (!instruction->applied) {
+			apply_instruction(instruction);
 		}
-
-		node->instruction = NULL;
 	}
 
 	cursor_rebase_all();
@@ -378,6 +502,13 @@ static int handle_timeout(void *data) {
 	struct sway_transaction *transaction = data;
 	sway_log(SWAY_DEBUG, "Transaction %p timed out (%zi waiting)",
 			transaction, transaction->num_waiting);
+	for (int i = 0; i < transaction->instructions->length; ++i) {
+		struct sway_transaction_instruction *instruction =
+			transaction->instructions->items[i];
+		if (instruction->waiting && !instruction->node->destroying) {
+			instruction->node->sway_container->view->configure_stats.timeouts++;
+		}
+	}
 	transaction->num_waiting = 0;
 	transaction_progress_queue();
 	return 0;
@@ -410,6 +541,96 @@ static bool should_configure(struct sway_node *node,
 	return true;
 }
 
+static struct sway_output *container_state_output(
+		struct sway_container_state *state) {
+	return state->workspace ? state->workspace->output : NULL;
+}
+
+/**
+ * The view is rendered from a saved buffer until the transaction applies.
+ * This is only needed if the view is going to redraw at a new size, is moving
+ * to another output (and may redraw for its scale) or is going away. Every
+ * other view keeps rendering its live surface.
+ */
+static bool should_save_buffer(struct sway_node *node,
+		struct sway_transaction_instruction *instruction, bool configured) {
+	if (!node_is_view(node)) {
+		return false;
+	}
+	if (!wl_list_empty(&node->sway_container->view->saved_buffers)) {
+		return false;
+	}
+	if (configured || node->destroying) {
+		return true;
+	}
+	return container_state_output(&node->sway_container->current) !=
+		container_state_output(&instruction->container_state);
+}
+
+static struct sway_output *instruction_output(
+		struct sway_transaction_instruction *instruction) {
+	struct sway_node *node = instruction->node;
+	switch (node->type) {
+	case N_ROOT:
+		return NULL;
+	case N_OUTPUT:
+		return node->sway_output;
+	case N_WORKSPACE:
+		return instruction->workspace_state.output;
+	case N_CONTAINER:
+		return container_state_output(&instruction->container_state);
+	}
+	return NULL;
+}
+
+/**
+ * A transaction can only be applied per output if no node in it moves
+ * between outputs, otherwise one output could show a node which the other
+ * output still has in its current tree.
+ */
+static bool transaction_can_split(struct sway_transaction *transaction) {
+	for (int i = 0; i < transaction->instructions->length; ++i) {
+		struct sway_transaction_instruction *instruction =
+			transaction->instructions->items[i];
+		struct sway_node *node = instruction->node;
+		struct sway_output *current = NULL;
+		if (node->type == N_WORKSPACE) {
+			current = node->sway_workspace->current.output;
+		} else if (node->type == N_CONTAINER) {
+			current = container_state_output(&node->sway_container->current);
+		}
+		if (current && current != instruction->output) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Apply the instructions for the given output if none of its views are still
+ * waiting, leaving the rest of the transaction to wait for slower views.
+ */
+static void transaction_apply_output_group(struct sway_transaction *transaction,
+		struct sway_output *output) {
+	for (int i = 0; i < transaction->instructions->length; ++i) {
+		struct sway_transaction_instruction *instruction =
+			transaction->instructions->items[i];
+		if (instruction->output == output && instruction->waiting) {
+			return;
+		}
+	}
+	sway_log(SWAY_DEBUG, "Transaction %p: applying instructions for %s",
+			transaction, output->wlr_output->name);
+	for (int i = 0; i < transaction->instructions->length; ++i) {
+		struct sway_transaction_instruction *instruction =
+			transaction->instructions->items[i];
+		if (instruction->output == output && !instruction->applied) {
+			apply_instruction(instruction);
+		}
+	}
+	cursor_rebase_all();
+}
+
 static void transaction_commit(struct sway_transaction *transaction) {
 	sway_log(SWAY_DEBUG, "Transaction %p committing with %i instructions",
 			transaction, transaction->instructions->length);
@@ -418,12 +639,15 @@ static void transaction_commit(struct sway_transaction *transaction) {
 		struct sway_transaction_instruction *instruction =
 			transaction->instructions->items[i];
 		struct sway_node *node = instruction->node;
-		if (should_configure(node, instruction)) {
+		instruction->output = instruction_output(instruction);
+		bool configured = should_configure(node, instruction);
+		if (configured) {
 			instruction->serial = view_configure(node->sway_container->view,
 					instruction->container_state.content_x,
 					instruction->container_state.content_y,
 					instruction->container_state.content_width,
 					instruction->container_state.content_height);
+			instruction->waiting = true;
 			++transaction->num_waiting;
 
 			// From here on we are rendering a saved buffer of the view, which
@@ -435,7 +659,7 @@ static void transaction_commit(struct sway_transaction *transaction) {
 			wlr_surface_send_frame_done(
 					node->sway_container->view->surface, &now);
 		}
-		if (node_is_view(node) && wl_list_empty(&node->sway_container->view->saved_buffers)) {
+		if (should_save_buffer(node, instruction, configured)) {
 			view_save_buffer(node->sway_container->view);
 			memcpy(&node->sway_container->view->saved_geometry,
 					&node->sway_container->view->geometry,
@@ -444,9 +668,9 @@ static void transaction_commit(struct sway_transaction *transaction) {
 		node->instruction = instruction;
 	}
 	transaction->num_configures = transaction->num_waiting;
-	if (debug.txn_timings) {
-		clock_gettime(CLOCK_MONOTONIC, &transaction->commit_time);
-	}
+	transaction->partial = debug.txn_partial && transaction->num_waiting > 1 &&
+		transaction_can_split(transaction);
+	clock_gettime(CLOCK_MONOTONIC, &transaction->commit_time);
 	if (debug.noatomic) {
 		transaction->num_waiting = 0;
 	} else if (debug.txn_wait) {
@@ -455,6 +679,17 @@ static void transaction_commit(struct sway_transaction *transaction) {
 		transaction->num_waiting += 1000000;
 	}
 
+	if (transaction->partial) {
+		// Outputs without any views to wait for can be applied straight away
+		for (int i = 0; i < transaction->instructions->length; ++i) {
+			struct sway_transaction_instruction *instruction =
+				transaction->instructions->items[i];
+			if (instruction->output && !instruction->applied) {
+				transaction_apply_output_group(transaction, instruction->output);
+			}
+		}
+	}
+
 	if (transaction->num_waiting) {
 		// Set up a timer which the views must respond within
 		transaction->timer = wl_event_loop_add_timer(server.wl_event_loop,
@@ -474,23 +709,35 @@ static void set_instruction_ready(
 		struct sway_transaction_instruction *instruction) {
 	struct sway_transaction *transaction = instruction->transaction;
 
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	struct timespec *start = &transaction->commit_time;
+	float ms = (now.tv_sec - start->tv_sec) * 1000 +
+		(now.tv_nsec - start->tv_nsec) / 1000000.0;
 	if (debug.txn_timings) {
-		struct timespec now;
-		clock_gettime(CLOCK_MONOTONIC, &now);
-		struct timespec *start = &transaction->commit_time;
-		float ms = (now.tv_sec - start->tv_sec) * 1000 +
-			(now.tv_nsec - start->tv_nsec) / 1000000.0;
 		sway_log(SWAY_DEBUG, "Transaction %p: %zi/%zi ready in %.1fms (%s)",
 				transaction,
 				transaction->num_configures - transaction->num_waiting + 1,
 				transaction->num_configures, ms,
 				instruction->node->sway_container->title);
 	}
+	if (instruction->waiting) {
+		struct sway_view *view = instruction->node->sway_container->view;
+		view->configure_stats.acks++;
+		view->configure_stats.total_ms += ms;
+		if (ms > view->configure_stats.max_ms) {
+			view->configure_stats.max_ms = ms;
+		}
+		instruction->waiting = false;
+	}
 
 	// If the transaction has timed out then its num_waiting will be 0 already.
 	if (transaction->num_waiting > 0 && --transaction->num_waiting == 0) {
 		sway_log(SWAY_DEBUG, "Transaction %p is ready", transaction);
 		wl_event_source_timer_update(transaction->timer, 0);
+	} else if (transaction->partial && transaction->num_waiting > 0 &&
+			instruction->output) {
+		transaction_apply_output_group(transaction, instruction->output);
 	}
 
 	instruction->node->instruction = NULL;
@@ -525,13 +772,33 @@ void transaction_commit_dirty(void) {
 	if (!transaction) {
 		return;
 	}
+	struct timespec start;
+	if (debug.txn_timings) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+	}
 	for (int i = 0; i < server.dirty_nodes->length; ++i) {
 		struct sway_node *node = server.dirty_nodes->items[i];
-		transaction_add_node(transaction, node);
+		if (node_state_changed(node)) {
+			transaction_add_node(transaction, node);
+		}
 		node->dirty = false;
 	}
+	if (debug.txn_timings) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		float ms = (now.tv_sec - start.tv_sec) * 1000 +
+			(now.tv_nsec - start.tv_nsec) / 1000000.0;
+		sway_log(SWAY_DEBUG, "Transaction %p: %.3fms to copy state of "
+				"%i/%i dirty nodes", transaction, ms,
+				transaction->instructions->length, server.dirty_nodes->length);
+	}
 	server.dirty_nodes->length = 0;
 
+	if (!transaction->instructions->length) {
+		transaction_destroy(transaction);
+		return;
+	}
+
 	list_add(server.transactions, transaction);
 
 	// We only commit the first transaction added to the queue.
@@ -19,6 +19,7 @@
 #include "sway/server.h"
 #include "sway/tree/view.h"
 #include "stringop.h"
+#include "intern.h"
 #include "list.h"
 #include "log.h"
 
@@ -62,7 +63,7 @@ struct sway_seat *input_manager_sway_seat_from_wlr_seat(struct wlr_seat *wlr_sea
 	return NULL;
 }
 
-char *input_device_get_identifier(struct wlr_input_device *device) {
+const char *input_device_get_identifier(struct wlr_input_device *device) {
 	int vendor = device->vendor;
 	int product = device->product;
 	char *name = strdup(device->name ? device->name : "");
@@ -81,12 +82,16 @@ char *input_device_get_identifier(struct wlr_input_device *device) {
 	char *identifier = malloc(len);
 	if (!identifier) {
 		sway_log(SWAY_ERROR, "Unable to allocate unique input device name");
+		free(name);
 		return NULL;
 	}
 
 	snprintf(identifier, len, fmt, vendor, product, name);
 	free(name);
-	return identifier;
+
+	const char *interned = intern_string(identifier);
+	free(identifier);
+	return interned;
 }
 
 static bool device_is_touchpad(struct sway_input_device *device) {
@@ -139,7 +144,7 @@ static void apply_input_type_config(struct sway_input_device *input_device) {
 
 	for (int i = 0; i < config->input_configs->length; i++) {
 		struct input_config *ic = config->input_configs->items[i];
-		if (strcmp(input_device->identifier, ic->identifier) == 0) {
+		if (input_device->identifier == ic->identifier) {
 			struct input_config *current = new_input_config(ic->identifier);
 			merge_input_config(current, type_config);
 			merge_input_config(current, ic);
@@ -211,7 +216,6 @@ static void handle_device_destroy(struct wl_listener *listener, void *data) {
 
 	wl_list_remove(&input_device->link);
 	wl_list_remove(&input_device->device_destroy.link);
-	free(input_device->identifier);
 	free(input_device);
 }
 
@@ -243,13 +247,14 @@ static void handle_new_input(struct wl_listener *listener, void *data) {
 
 	input_manager_verify_fallback_seat();
 
+	const char *wildcard = intern_string("*");
 	bool added = false;
 	struct sway_seat *seat = NULL;
 	wl_list_for_each(seat, &input->seats, link) {
 		struct seat_config *seat_config = seat_get_config(seat);
 		bool has_attachment = seat_config &&
 			(seat_config_get_attachment(seat_config, input_device->identifier) ||
-			 seat_config_get_attachment(seat_config, "*"));
+			 seat_config_get_attachment(seat_config, wildcard));
 
 		if (has_attachment) {
 			seat_add_device(seat, input_device);
@@ -545,7 +550,7 @@ void input_manager_apply_input_config(struct input_config *input_config) {
 	wl_list_for_each(input_device, &server.input->devices, link) {
 		bool type_matches = type_wildcard &&
 			strcmp(input_device_get_type(input_device), input_config->identifier + 5) == 0;
-		if (strcmp(input_device->identifier, input_config->identifier) == 0
+		if (input_device->identifier == input_config->identifier
 				|| wildcard
 				|| type_matches) {
 			input_manager_configure_input(input_device);
@@ -605,6 +610,7 @@ void input_manager_apply_seat_config(struct seat_config *seat_config) {
 
 	// for every device, try to add it to a seat and if no seat has it
 	// attached, add it to the fallback seats.
+	const char *wildcard = intern_string("*");
 	struct sway_input_device *input_device = NULL;
 	wl_list_for_each(input_device, &server.input->devices, link) {
 		list_t *seat_list = create_list();
@@ -614,7 +620,7 @@ void input_manager_apply_seat_config(struct seat_config *seat_config) {
 			if (!seat_config) {
 				continue;
 			}
-			if (seat_config_get_attachment(seat_config, "*") ||
+			if (seat_config_get_attachment(seat_config, wildcard) ||
 					seat_config_get_attachment(seat_config,
 						input_device->identifier)) {
 				list_add(seat_list, seat);
@@ -662,7 +668,7 @@ struct input_config *input_device_get_config(struct sway_input_device *device) {
 	struct input_config *input_config = NULL;
 	for (int i = 0; i < config->input_configs->length; ++i) {
 		input_config = config->input_configs->items[i];
-		if (strcmp(input_config->identifier, device->identifier) == 0) {
+		if (input_config->identifier == device->identifier) {
 			return input_config;
 		} else if (strcmp(input_config->identifier, "*") == 0) {
 			wildcard_config = input_config;
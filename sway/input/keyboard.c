@@ -147,7 +147,8 @@ static bool update_shortcut_state(struct sway_shortcut_state *state,
 
 /**
  * If one exists, finds a binding which matches the shortcut model state,
- * current modifiers, release state, and locked state.
+ * current modifiers, release state, and locked state. The input identifier
+ * must be interned.
  */
 static void get_active_binding(const struct sway_shortcut_state *state,
 		list_t *bindings, struct sway_binding **current_binding,
@@ -165,7 +166,7 @@ static void get_active_binding(const struct sway_shortcut_state *state,
 				inhibited > binding_inhibited ||
 				(binding->group != XKB_LAYOUT_INVALID &&
 				 binding->group != group) ||
-				(strcmp(binding->input, input) != 0 &&
+				(binding->input != input &&
 				 (strcmp(binding->input, "*") != 0 || exact_input))) {
 			continue;
 		}
@@ -200,10 +201,10 @@ static void get_active_binding(const struct sway_shortcut_state *state,
 				((*current_binding)->flags & BINDING_LOCKED) != 0;
 			bool current_inhibited =
 				((*current_binding)->flags & BINDING_INHIBITED) != 0;
-			bool current_input = strcmp((*current_binding)->input, input) == 0;
+			bool current_input = (*current_binding)->input == input;
 			bool current_group_set =
 				(*current_binding)->group != XKB_LAYOUT_INVALID;
-			bool binding_input = strcmp(binding->input, input) == 0;
+			bool binding_input = binding->input == input;
 			bool binding_group_set = binding->group != XKB_LAYOUT_INVALID;
 
 			if (current_input == binding_input
@@ -242,7 +243,7 @@ static void get_active_binding(const struct sway_shortcut_state *state,
 		}
 
 		*current_binding = binding;
-		if (strcmp((*current_binding)->input, input) == 0 &&
+		if ((*current_binding)->input == input &&
 				(((*current_binding)->flags & BINDING_LOCKED) == locked) &&
 				(((*current_binding)->flags & BINDING_INHIBITED) == inhibited) &&
 				(*current_binding)->group == group) {
@@ -384,7 +385,8 @@ static void handle_key_event(struct sway_keyboard *keyboard,
 	struct wlr_seat *wlr_seat = seat->wlr_seat;
 	struct wlr_input_device *wlr_device =
 		keyboard->seat_device->input_device->wlr_device;
-	char *device_identifier = input_device_get_identifier(wlr_device);
+	const char *device_identifier =
+		keyboard->seat_device->input_device->identifier;
 	bool exact_identifier = wlr_device->keyboard->group != NULL;
 	seat_idle_notify_activity(seat, IDLE_SOURCE_KEYBOARD);
 	bool input_inhibited = seat->exclusive_client != NULL;
@@ -468,7 +470,6 @@ static void handle_key_event(struct sway_keyboard *keyboard,
 
 	if (!handled && wlr_device->keyboard->group) {
 		// Only handle device specific bindings for keyboards in a group
-		free(device_identifier);
 		return;
 	}
 
@@ -496,8 +497,6 @@ static void handle_key_event(struct sway_keyboard *keyboard,
 	}
 
 	transaction_commit_dirty();
-
-	free(device_identifier);
 }
 
 static void handle_keyboard_key(struct wl_listener *listener, void *data) {
@@ -891,6 +890,8 @@ static void sway_keyboard_group_add(struct sway_keyboard *keyboard) {
 	}
 	sway_group->seat_device->input_device->wlr_device =
 		sway_group->wlr_group->input_device;
+	sway_group->seat_device->input_device->identifier =
+		input_device_get_identifier(sway_group->wlr_group->input_device);
 
 	if (!sway_keyboard_create(seat, sway_group->seat_device)) {
 		sway_log(SWAY_ERROR, "Failed to allocate sway_keyboard for group");
@@ -46,6 +46,13 @@ static void seat_device_destroy(struct sway_seat_device *seat_device) {
 	free(seat_device);
 }
 
+static void seat_node_destroy(struct sway_seat_node *seat_node) {
+	wl_list_remove(&seat_node->destroy.link);
+	wl_list_remove(&seat_node->link);
+	wl_list_remove(&seat_node->node_link);
+	free(seat_node);
+}
+
 void seat_destroy(struct sway_seat *seat) {
 	struct sway_seat_device *seat_device, *next;
 	wl_list_for_each_safe(seat_device, next, &seat->devices, link) {
@@ -59,6 +66,10 @@ void seat_destroy(struct sway_seat *seat) {
 	wl_list_remove(&seat->request_set_primary_selection.link);
 	wl_list_remove(&seat->link);
 	wlr_seat_destroy(seat->wlr_seat);
+	struct sway_seat_node *seat_node, *next_seat_node;
+	wl_list_for_each_safe(seat_node, next_seat_node, &seat->focus_stack, link) {
+		seat_node_destroy(seat_node);
+	}
 	for (int i = 0; i < seat->deferred_bindings->length; i++) {
 		free_sway_binding(seat->deferred_bindings->items[i]);
 	}
@@ -67,12 +78,6 @@ void seat_destroy(struct sway_seat *seat) {
 	free(seat);
 }
 
-static void seat_node_destroy(struct sway_seat_node *seat_node) {
-	wl_list_remove(&seat_node->destroy.link);
-	wl_list_remove(&seat_node->link);
-	free(seat_node);
-}
-
 void seat_idle_notify_activity(struct sway_seat *seat,
 		enum sway_input_idle_source source) {
 	uint32_t mask = seat->idle_inhibit_sources;
@@ -197,20 +202,111 @@ void seat_for_each_node(struct sway_seat *seat,
 	}
 }
 
+static struct sway_seat_node *seat_node_lookup(struct sway_seat *seat,
+		struct sway_node *node) {
+	struct sway_seat_node *seat_node;
+	wl_list_for_each(seat_node, &node->seat_nodes, node_link) {
+		if (seat_node->seat == seat) {
+			return seat_node;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Finds the most recently focused node of a set of nodes. The focus stack is
+ * ordered by focus_seq, so this gives the same result as searching the focus
+ * stack for the first node of the set, but only costs as much as the set is
+ * large instead of as much as the whole focus stack.
+ */
+struct focus_search {
+	struct sway_seat *seat;
+	bool views_only;
+
+	struct sway_node *node;
+	int64_t focus_seq;
+};
+
+static void focus_search_add(struct focus_search *search,
+		struct sway_node *node) {
+	struct sway_seat_node *seat_node = seat_node_lookup(search->seat, node);
+	if (seat_node && (!search->node || seat_node->focus_seq > search->focus_seq)) {
+		search->node = node;
+		search->focus_seq = seat_node->focus_seq;
+	}
+}
+
+static void focus_search_container_iterator(struct sway_container *con,
+		void *data) {
+	struct focus_search *search = data;
+	if (!search->views_only || con->view) {
+		focus_search_add(search, &con->node);
+	}
+}
+
+static void focus_search_containers(struct focus_search *search,
+		list_t *containers) {
+	for (int i = 0; i < containers->length; ++i) {
+		struct sway_container *con = containers->items[i];
+		focus_search_container_iterator(con, search);
+		container_for_each_child(con, focus_search_container_iterator, search);
+	}
+}
+
+static void focus_search_workspace(struct focus_search *search,
+		struct sway_workspace *ws) {
+	focus_search_containers(search, ws->tiling);
+	focus_search_containers(search, ws->floating);
+}
+
+/**
+ * Adds all descendants of the node to the search. Must not be used for the
+ * root, which can also have global fullscreen and scratchpad descendants.
+ */
+static void focus_search_descendants(struct focus_search *search,
+		struct sway_node *node) {
+	switch (node->type) {
+	case N_ROOT:
+		sway_assert(false, "Can't search the root's descendants");
+		break;
+	case N_OUTPUT:
+		for (int i = 0; i < node->sway_output->workspaces->length; ++i) {
+			struct sway_workspace *ws = node->sway_output->workspaces->items[i];
+			if (!search->views_only) {
+				focus_search_add(search, &ws->node);
+			}
+			focus_search_workspace(search, ws);
+		}
+		break;
+	case N_WORKSPACE:
+		focus_search_workspace(search, node->sway_workspace);
+		break;
+	case N_CONTAINER:
+		container_for_each_child(node->sway_container,
+				focus_search_container_iterator, search);
+		break;
+	}
+}
+
 struct sway_container *seat_get_focus_inactive_view(struct sway_seat *seat,
 		struct sway_node *ancestor) {
 	if (ancestor->type == N_CONTAINER && ancestor->sway_container->view) {
 		return ancestor->sway_container;
 	}
-	struct sway_seat_node *current;
-	wl_list_for_each(current, &seat->focus_stack, link) {
-		struct sway_node *node = current->node;
-		if (node->type == N_CONTAINER && node->sway_container->view &&
-				node_has_ancestor(node, ancestor)) {
-			return node->sway_container;
+	if (ancestor->type == N_ROOT) {
+		struct sway_seat_node *current;
+		wl_list_for_each(current, &seat->focus_stack, link) {
+			struct sway_node *node = current->node;
+			if (node->type == N_CONTAINER && node->sway_container->view &&
+					node_has_ancestor(node, ancestor)) {
+				return node->sway_container;
+			}
 		}
+		return NULL;
 	}
-	return NULL;
+	struct focus_search search = { .seat = seat, .views_only = true };
+	focus_search_descendants(&search, ancestor);
+	return search.node ? search.node->sway_container : NULL;
 }
 
 static void handle_seat_node_destroy(struct wl_listener *listener, void *data) {
@@ -313,11 +409,9 @@ static struct sway_seat_node *seat_node_from_node(
 		return NULL;
 	}
 
-	struct sway_seat_node *seat_node = NULL;
-	wl_list_for_each(seat_node, &seat->focus_stack, link) {
-		if (seat_node->node == node) {
-			return seat_node;
-		}
+	struct sway_seat_node *seat_node = seat_node_lookup(seat, node);
+	if (seat_node) {
+		return seat_node;
 	}
 
 	seat_node = calloc(1, sizeof(struct sway_seat_node));
@@ -328,7 +422,9 @@ static struct sway_seat_node *seat_node_from_node(
 
 	seat_node->node = node;
 	seat_node->seat = seat;
+	seat_node->focus_seq = --seat->focus_seq_bottom;
 	wl_list_insert(seat->focus_stack.prev, &seat_node->link);
+	wl_list_insert(&node->seat_nodes, &seat_node->node_link);
 	wl_signal_add(&node->events.destroy, &seat_node->destroy);
 	seat_node->destroy.notify = handle_seat_node_destroy;
 
@@ -520,6 +616,7 @@ static void collect_focus_iter(struct sway_node *node, void *data) {
 	}
 	wl_list_remove(&seat_node->link);
 	wl_list_insert(&seat->focus_stack, &seat_node->link);
+	seat_node->focus_seq = ++seat->focus_seq_top;
 }
 
 static void collect_focus_workspace_iter(struct sway_workspace *workspace,
@@ -1037,6 +1134,7 @@ void seat_set_raw_focus(struct sway_seat *seat, struct sway_node *node) {
 	struct sway_seat_node *seat_node = seat_node_from_node(seat, node);
 	wl_list_remove(&seat_node->link);
 	wl_list_insert(&seat->focus_stack, &seat_node->link);
+	seat_node->focus_seq = ++seat->focus_seq_top;
 	node_set_dirty(node);
 
 	// If focusing a scratchpad container that is fullscreen global, parent
@@ -1293,11 +1391,20 @@ struct sway_node *seat_get_focus_inactive(struct sway_seat *seat,
 	if (node_is_view(node)) {
 		return node;
 	}
-	struct sway_seat_node *current;
-	wl_list_for_each(current, &seat->focus_stack, link) {
-		if (node_has_ancestor(current->node, node)) {
-			return current->node;
+	if (node->type == N_ROOT) {
+		// The focused node is nearly always at the top of the stack
+		struct sway_seat_node *current;
+		wl_list_for_each(current, &seat->focus_stack, link) {
+			if (node_has_ancestor(current->node, node)) {
+				return current->node;
+			}
 		}
+		return NULL;
+	}
+	struct focus_search search = { .seat = seat };
+	focus_search_descendants(&search, node);
+	if (search.node) {
+		return search.node;
 	}
 	if (node->type == N_WORKSPACE) {
 		return node;
@@ -1307,36 +1414,16 @@ struct sway_node *seat_get_focus_inactive(struct sway_seat *seat,
 
 struct sway_container *seat_get_focus_inactive_tiling(struct sway_seat *seat,
 		struct sway_workspace *workspace) {
-	if (!workspace->tiling->length) {
-		return NULL;
-	}
-	struct sway_seat_node *current;
-	wl_list_for_each(current, &seat->focus_stack, link) {
-		struct sway_node *node = current->node;
-		if (node->type == N_CONTAINER &&
-				!container_is_floating_or_child(node->sway_container) &&
-				node->sway_container->workspace == workspace) {
-			return node->sway_container;
-		}
-	}
-	return NULL;
+	struct focus_search search = { .seat = seat };
+	focus_search_containers(&search, workspace->tiling);
+	return search.node ? search.node->sway_container : NULL;
 }
 
 struct sway_container *seat_get_focus_inactive_floating(struct sway_seat *seat,
 		struct sway_workspace *workspace) {
-	if (!workspace->floating->length) {
-		return NULL;
-	}
-	struct sway_seat_node *current;
-	wl_list_for_each(current, &seat->focus_stack, link) {
-		struct sway_node *node = current->node;
-		if (node->type == N_CONTAINER &&
-				container_is_floating_or_child(node->sway_container) &&
-				node->sway_container->workspace == workspace) {
-			return node->sway_container;
-		}
-	}
-	return NULL;
+	struct focus_search search = { .seat = seat };
+	focus_search_containers(&search, workspace->floating);
+	return search.node ? search.node->sway_container : NULL;
 }
 
 struct sway_node *seat_get_active_tiling_child(struct sway_seat *seat,
@@ -1344,22 +1431,34 @@ struct sway_node *seat_get_active_tiling_child(struct sway_seat *seat,
 	if (node_is_view(parent)) {
 		return parent;
 	}
-	struct sway_seat_node *current;
-	wl_list_for_each(current, &seat->focus_stack, link) {
-		struct sway_node *node = current->node;
-		if (node_get_parent(node) != parent) {
-			continue;
+	struct focus_search search = { .seat = seat };
+	switch (parent->type) {
+	case N_ROOT:
+		break;
+	case N_OUTPUT:
+		for (int i = 0; i < parent->sway_output->workspaces->length; ++i) {
+			struct sway_workspace *ws =
+				parent->sway_output->workspaces->items[i];
+			focus_search_add(&search, &ws->node);
 		}
-		if (parent->type == N_WORKSPACE) {
-			// Only consider tiling children
-			struct sway_workspace *ws = parent->sway_workspace;
-			if (list_find(ws->tiling, node->sway_container) == -1) {
-				continue;
-			}
+		break;
+	case N_WORKSPACE:
+		// Only consider tiling children
+		for (int i = 0; i < parent->sway_workspace->tiling->length; ++i) {
+			struct sway_container *child =
+				parent->sway_workspace->tiling->items[i];
+			focus_search_add(&search, &child->node);
 		}
-		return node;
+		break;
+	case N_CONTAINER:
+		for (int i = 0; i < parent->sway_container->children->length; ++i) {
+			struct sway_container *child =
+				parent->sway_container->children->items[i];
+			focus_search_add(&search, &child->node);
+		}
+		break;
 	}
-	return NULL;
+	return search.node;
 }
 
 struct sway_node *seat_get_focus(struct sway_seat *seat) {
@@ -8,6 +8,7 @@
 #include "sway/input/seat.h"
 #include "sway/input/tablet.h"
 #include "sway/tree/view.h"
+#include "intern.h"
 #include "log.h"
 #if HAVE_XWAYLAND
 #include "sway/xwayland.h"
@@ -124,7 +125,7 @@ static struct sway_binding* get_active_mouse_binding(
 				!(click_region & binding->flags) ||
 				(on_workspace &&
 				 (click_region & binding->flags) != click_region) ||
-				(strcmp(binding->input, identifier) != 0 &&
+				(binding->input != identifier &&
 				 strcmp(binding->input, "*") != 0)) {
 			continue;
 		}
@@ -143,7 +144,7 @@ static struct sway_binding* get_active_mouse_binding(
 
 		if (!current || strcmp(current->input, "*") == 0) {
 			current = binding;
-			if (strcmp(current->input, identifier) == 0) {
+			if (current->input == identifier) {
 				// If a binding is found for the exact input, quit searching
 				break;
 			}
@@ -288,8 +289,9 @@ static bool trigger_pointer_button_binding(struct sway_seat *seat,
 
 	struct seatop_default_event *e = seat->seatop_data;
 
-	char *device_identifier = device ? input_device_get_identifier(device)
-		: strdup("*");
+	struct sway_input_device *input_device = device ? device->data : NULL;
+	const char *device_identifier = input_device ?
+		input_device->identifier : intern_string("*");
 	struct sway_binding *binding = NULL;
 	if (state == WLR_BUTTON_PRESSED) {
 		state_add_button(e, button);
@@ -305,7 +307,6 @@ static bool trigger_pointer_button_binding(struct sway_seat *seat,
 		state_erase_button(e, button);
 	}
 
-	free(device_identifier);
 	if (binding) {
 		seat_execute_command(seat, binding);
 		return true;
@@ -655,9 +656,8 @@ static void handle_pointer_axis(struct sway_seat *seat,
 	// Gather information needed for mouse bindings
 	struct wlr_keyboard *keyboard = wlr_seat_get_keyboard(seat->wlr_seat);
 	uint32_t modifiers = keyboard ? wlr_keyboard_get_modifiers(keyboard) : 0;
-	struct wlr_input_device *device =
-		input_device ? input_device->wlr_device : NULL;
-	char *dev_id = device ? input_device_get_identifier(device) : strdup("*");
+	const char *dev_id = input_device ?
+		input_device->identifier : intern_string("*");
 	uint32_t button = wl_axis_to_button(event);
 
 	// Handle mouse bindings - x11 mouse buttons 4-7 - press event
@@ -712,7 +712,6 @@ static void handle_pointer_axis(struct sway_seat *seat,
 		seat_execute_command(seat, binding);
 		handled = true;
 	}
-	free(dev_id);
 
 	if (!handled) {
 		wlr_seat_pointer_notify_axis(cursor->seat->wlr_seat, event->time_msec,
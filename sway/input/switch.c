@@ -73,12 +73,9 @@ static void handle_switch_toggle(struct wl_listener *listener, void *data) {
 	struct sway_seat *seat = sway_switch->seat_device->sway_seat;
 	seat_idle_notify_activity(seat, IDLE_SOURCE_SWITCH);
 
-	struct wlr_input_device *wlr_device =
-		sway_switch->seat_device->input_device->wlr_device;
-	char *device_identifier = input_device_get_identifier(wlr_device);
-	sway_log(SWAY_DEBUG, "%s: type %d state %d", device_identifier,
+	sway_log(SWAY_DEBUG, "%s: type %d state %d",
+			sway_switch->seat_device->input_device->identifier,
 			event->switch_type, event->switch_state);
-	free(device_identifier);
 
 	sway_switch->type = event->switch_type;
 	sway_switch->state = event->switch_state;
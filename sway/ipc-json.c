@@ -405,7 +405,7 @@ static json_object *ipc_json_describe_scratchpad_output(void) {
 }
 
 static void ipc_json_describe_workspace(struct sway_workspace *workspace,
-		json_object *object) {
+		json_object *object, bool shallow) {
 	int num;
 	if (isdigit(workspace->name[0])) {
 		errno = 0;
@@ -438,7 +438,7 @@ static void ipc_json_describe_workspace(struct sway_workspace *workspace,
 
 	// Floating
 	json_object *floating_array = json_object_new_array();
-	for (int i = 0; i < workspace->floating->length; ++i) {
+	for (int i = 0; !shallow && i < workspace->floating->length; ++i) {
 		struct sway_container *floater = workspace->floating->items[i];
 		json_object_array_add(floating_array,
 				ipc_json_describe_node_recursive(&floater->node));
@@ -539,6 +539,18 @@ static void ipc_json_describe_view(struct sway_container *c, json_object *object
 
 	json_object_object_add(object, "idle_inhibitors", idle_inhibitors);
 
+	json_object *configure_stats = json_object_new_object();
+	uint32_t acks = c->view->configure_stats.acks;
+	json_object_object_add(configure_stats, "acks", json_object_new_int(acks));
+	json_object_object_add(configure_stats, "timeouts",
+			json_object_new_int(c->view->configure_stats.timeouts));
+	json_object_object_add(configure_stats, "average_ms",
+			json_object_new_double(acks ?
+				c->view->configure_stats.total_ms / acks : 0));
+	json_object_object_add(configure_stats, "max_ms",
+			json_object_new_double(c->view->configure_stats.max_ms));
+	json_object_object_add(object, "configure_stats", configure_stats);
+
 #if HAVE_XWAYLAND
 	if (c->view->type == SWAY_VIEW_XWAYLAND) {
 		json_object_object_add(object, "window",
@@ -667,7 +679,7 @@ static void focus_inactive_children_iterator(struct sway_node *node,
 	json_object_array_add(focus, json_object_new_int(node->id));
 }
 
-json_object *ipc_json_describe_node(struct sway_node *node) {
+static json_object *describe_node(struct sway_node *node, bool shallow) {
 	struct sway_seat *seat = input_manager_get_default_seat();
 	bool focused = seat_get_focus(seat) == node;
 	char *name = node_get_name(node);
@@ -706,13 +718,21 @@ json_object *ipc_json_describe_node(struct sway_node *node) {
 		ipc_json_describe_container(node->sway_container, object);
 		break;
 	case N_WORKSPACE:
-		ipc_json_describe_workspace(node->sway_workspace, object);
+		ipc_json_describe_workspace(node->sway_workspace, object, shallow);
 		break;
 	}
 
 	return object;
 }
 
+json_object *ipc_json_describe_node(struct sway_node *node) {
+	return describe_node(node, false);
+}
+
+json_object *ipc_json_describe_node_shallow(struct sway_node *node) {
+	return describe_node(node, true);
+}
+
 json_object *ipc_json_describe_node_recursive(struct sway_node *node) {
 	json_object *object = ipc_json_describe_node(node);
 	int i;
@@ -1268,3 +1288,30 @@ json_object *ipc_json_get_binding_mode(void) {
 			json_object_new_string(config->current_mode->name));
 	return current_mode;
 }
+
+static json_object *describe_config_profile_entries(list_t *entries) {
+	json_object *array = json_object_new_array();
+	for (int i = 0; i < entries->length; ++i) {
+		struct config_profile_entry *entry = entries->items[i];
+		json_object *json = json_object_new_object();
+		json_object_object_add(json, "name",
+				json_object_new_string(entry->name));
+		json_object_object_add(json, "count",
+				json_object_new_int(entry->count));
+		json_object_object_add(json, "time",
+				json_object_new_double(entry->nsec / 1000000.0));
+		json_object_array_add(array, json);
+	}
+	return array;
+}
+
+json_object *ipc_json_describe_config_profile(struct config_profile *profile) {
+	json_object *json = json_object_new_object();
+	json_object_object_add(json, "phases",
+			describe_config_profile_entries(profile->phases));
+	json_object_object_add(json, "files",
+			describe_config_profile_entries(profile->files));
+	json_object_object_add(json, "handlers",
+			describe_config_profile_entries(profile->handlers));
+	return json;
+}
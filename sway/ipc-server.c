@@ -48,6 +48,8 @@ struct ipc_client {
 	struct sway_server *server;
 	int fd;
 	enum ipc_command_type subscribed_events;
+	// Events for which the client asked for payloads without subtrees
+	enum ipc_command_type shallow_events;
 	size_t write_buffer_len;
 	size_t write_buffer_size;
 	char *write_buffer;
@@ -280,6 +282,38 @@ static bool ipc_has_event_listeners(enum ipc_command_type event) {
 	return false;
 }
 
+static bool ipc_has_event_listeners_shallow(enum ipc_command_type event,
+		bool shallow) {
+	for (int i = 0; i < ipc_client_list->length; i++) {
+		struct ipc_client *client = ipc_client_list->items[i];
+		if ((client->subscribed_events & event_mask(event)) != 0 &&
+				((client->shallow_events & event_mask(event)) != 0) == shallow) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void ipc_send_event_shallow(const char *json_string,
+		enum ipc_command_type event, bool shallow) {
+	struct ipc_client *client;
+	for (int i = 0; i < ipc_client_list->length; i++) {
+		client = ipc_client_list->items[i];
+		if ((client->subscribed_events & event_mask(event)) == 0 ||
+				((client->shallow_events & event_mask(event)) != 0) != shallow) {
+			continue;
+		}
+		if (!ipc_send_reply(client, event, json_string,
+				(uint32_t)strlen(json_string))) {
+			sway_log_errno(SWAY_INFO, "Unable to send reply to IPC client");
+			/* ipc_send_reply destroys client on error, which also
+			 * removes it from the list, so we need to process
+			 * current index again */
+			i--;
+		}
+	}
+}
+
 static void ipc_send_event(const char *json_string, enum ipc_command_type event) {
 	struct ipc_client *client;
 	for (int i = 0; i < ipc_client_list->length; i++) {
@@ -298,48 +332,71 @@ static void ipc_send_event(const char *json_string, enum ipc_command_type event)
 	}
 }
 
-void ipc_event_workspace(struct sway_workspace *old,
-		struct sway_workspace *new, const char *change) {
-	if (!ipc_has_event_listeners(IPC_EVENT_WORKSPACE)) {
-		return;
+static json_object *describe_event_node(struct sway_node *node, bool shallow) {
+	if (!node) {
+		return NULL;
 	}
-	sway_log(SWAY_DEBUG, "Sending workspace::%s event", change);
+	return shallow ? ipc_json_describe_node_shallow(node) :
+		ipc_json_describe_node_recursive(node);
+}
+
+static void send_workspace_event(struct sway_workspace *old,
+		struct sway_workspace *new, const char *change, bool shallow) {
 	json_object *obj = json_object_new_object();
 	json_object_object_add(obj, "change", json_object_new_string(change));
-	if (old) {
-		json_object_object_add(obj, "old",
-				ipc_json_describe_node_recursive(&old->node));
-	} else {
-		json_object_object_add(obj, "old", NULL);
-	}
-
-	if (new) {
-		json_object_object_add(obj, "current",
-				ipc_json_describe_node_recursive(&new->node));
-	} else {
-		json_object_object_add(obj, "current", NULL);
-	}
+	json_object_object_add(obj, "old",
+			describe_event_node(old ? &old->node : NULL, shallow));
+	json_object_object_add(obj, "current",
+			describe_event_node(new ? &new->node : NULL, shallow));
 
 	const char *json_string = json_object_to_json_string(obj);
-	ipc_send_event(json_string, IPC_EVENT_WORKSPACE);
+	ipc_send_event_shallow(json_string, IPC_EVENT_WORKSPACE, shallow);
 	json_object_put(obj);
 }
 
-void ipc_event_window(struct sway_container *window, const char *change) {
-	if (!ipc_has_event_listeners(IPC_EVENT_WINDOW)) {
+void ipc_event_workspace(struct sway_workspace *old,
+		struct sway_workspace *new, const char *change) {
+	bool full = ipc_has_event_listeners_shallow(IPC_EVENT_WORKSPACE, false);
+	bool shallow = ipc_has_event_listeners_shallow(IPC_EVENT_WORKSPACE, true);
+	if (!full && !shallow) {
 		return;
 	}
-	sway_log(SWAY_DEBUG, "Sending window::%s event", change);
+	sway_log(SWAY_DEBUG, "Sending workspace::%s event", change);
+	if (full) {
+		send_workspace_event(old, new, change, false);
+	}
+	if (shallow) {
+		send_workspace_event(old, new, change, true);
+	}
+}
+
+static void send_window_event(struct sway_container *window,
+		const char *change, bool shallow) {
 	json_object *obj = json_object_new_object();
 	json_object_object_add(obj, "change", json_object_new_string(change));
 	json_object_object_add(obj, "container",
-			ipc_json_describe_node_recursive(&window->node));
+			describe_event_node(&window->node, shallow));
 
 	const char *json_string = json_object_to_json_string(obj);
-	ipc_send_event(json_string, IPC_EVENT_WINDOW);
+	ipc_send_event_shallow(json_string, IPC_EVENT_WINDOW, shallow);
 	json_object_put(obj);
 }
 
+void ipc_event_window(struct sway_container *window, const char *change) {
+	bool full = ipc_has_event_listeners_shallow(IPC_EVENT_WINDOW, false);
+	bool shallow = ipc_has_event_listeners_shallow(IPC_EVENT_WINDOW, true);
+	if (!full && !shallow) {
+		return;
+	}
+	sway_log(SWAY_DEBUG, "Sending window::%s event", change);
+	if (full) {
+		send_window_event(window, change, false);
+	}
+	if (shallow) {
+		send_window_event(window, change, true);
+	}
+}
+
 void ipc_event_barconfig_update(struct bar_config *bar) {
 	if (!ipc_has_event_listeners(IPC_EVENT_BARCONFIG_UPDATE)) {
 		return;
@@ -724,9 +781,27 @@ void ipc_client_handle_command(struct ipc_client *client, uint32_t payload_lengt
 		bool is_tick = false;
 		// parse requested event types
 		for (size_t i = 0; i < json_object_array_length(request); i++) {
-			const char *event_type = json_object_get_string(json_object_array_get_idx(request, i));
+			json_object *item = json_object_array_get_idx(request, i);
+			bool shallow = false;
+			if (json_object_is_type(item, json_type_object)) {
+				// { "event": "workspace", "shallow": true }
+				json_object *json_shallow;
+				if (json_object_object_get_ex(item, "shallow", &json_shallow)) {
+					shallow = json_object_get_boolean(json_shallow);
+				}
+				json_object_object_get_ex(item, "event", &item);
+			}
+			const char *event_type = json_object_get_string(item);
+			if (!event_type) {
+				event_type = "";
+			}
 			if (strcmp(event_type, "workspace") == 0) {
 				client->subscribed_events |= event_mask(IPC_EVENT_WORKSPACE);
+				if (shallow) {
+					client->shallow_events |= event_mask(IPC_EVENT_WORKSPACE);
+				} else {
+					client->shallow_events &= ~event_mask(IPC_EVENT_WORKSPACE);
+				}
 			} else if (strcmp(event_type, "barconfig_update") == 0) {
 				client->subscribed_events |= event_mask(IPC_EVENT_BARCONFIG_UPDATE);
 			} else if (strcmp(event_type, "bar_state_update") == 0) {
@@ -737,6 +812,11 @@ void ipc_client_handle_command(struct ipc_client *client, uint32_t payload_lengt
 				client->subscribed_events |= event_mask(IPC_EVENT_SHUTDOWN);
 			} else if (strcmp(event_type, "window") == 0) {
 				client->subscribed_events |= event_mask(IPC_EVENT_WINDOW);
+				if (shallow) {
+					client->shallow_events |= event_mask(IPC_EVENT_WINDOW);
+				} else {
+					client->shallow_events &= ~event_mask(IPC_EVENT_WINDOW);
+				}
 			} else if (strcmp(event_type, "binding") == 0) {
 				client->subscribed_events |= event_mask(IPC_EVENT_BINDING);
 			} else if (strcmp(event_type, "tick") == 0) {
@@ -889,6 +969,10 @@ void ipc_client_handle_command(struct ipc_client *client, uint32_t payload_lengt
 	{
 		json_object *json = json_object_new_object();
 		json_object_object_add(json, "config", json_object_new_string(config->current_config));
+		if (config->profile) {
+			json_object_object_add(json, "profile",
+				ipc_json_describe_config_profile(config->profile));
+		}
 		const char *json_string = json_object_to_json_string(json);
 		ipc_send_reply(client, payload_type, json_string,
 			(uint32_t)strlen(json_string));
@@ -216,6 +216,12 @@ void enable_debug_flag(const char *flag) {
 		debug.txn_wait = true;
 	} else if (strcmp(flag, "txn-timings") == 0) {
 		debug.txn_timings = true;
+	} else if (strcmp(flag, "txn-partial") == 0) {
+		debug.txn_partial = true;
+	} else if (strcmp(flag, "profile-config") == 0) {
+		debug.profile_config = true;
+	} else if (strcmp(flag, "render-stats") == 0) {
+		debug.render_stats = true;
 	} else if (strncmp(flag, "txn-timeout=", 12) == 0) {
 		server.txn_timeout_ms = atoi(&flag[12]);
 	} else {
@@ -234,6 +240,7 @@ int main(int argc, char **argv) {
 		{"version", no_argument, NULL, 'v'},
 		{"verbose", no_argument, NULL, 'V'},
 		{"get-socketpath", no_argument, NULL, 'p'},
+		{"profile-config", no_argument, NULL, 'P'},
 		{"unsupported-gpu", no_argument, NULL, 'u'},
 		{"my-next-gpu-wont-be-nvidia", no_argument, NULL, 'u'},
 		{0, 0, 0, 0}
@@ -251,6 +258,7 @@ int main(int argc, char **argv) {
 		"  -v, --version          Show the version number and quit.\n"
 		"  -V, --verbose          Enables more verbose logging.\n"
 		"      --get-socketpath   Gets the IPC socket path and prints it, then exits.\n"
+		"      --profile-config   Logs time spent loading the config. Implies -V.\n"
 		"\n";
 
 	int c;
@@ -288,6 +296,10 @@ int main(int argc, char **argv) {
 		case 'V': // verbose
 			verbose = 1;
 			break;
+		case 'P': // --profile-config
+			enable_debug_flag("profile-config");
+			verbose = 1;
+			break;
 		case 'p': ; // --get-socketpath
 			if (getenv("SWAYSOCK")) {
 				fprintf(stdout, "%s\n", getenv("SWAYSOCK"));
@@ -393,6 +405,7 @@ int main(int argc, char **argv) {
 		sway_terminate(EXIT_FAILURE);
 		goto shutdown;
 	}
+	config_profile_log(config->profile);
 
 	if (!server_start(&server)) {
 		sway_terminate(EXIT_FAILURE);
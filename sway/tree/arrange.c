@@ -13,7 +13,8 @@
 #include "list.h"
 #include "log.h"
 
-static void apply_horiz_layout(list_t *children, struct wlr_box *parent) {
+static void apply_horiz_layout(list_t *children, struct wlr_box *parent,
+		bool in_tabbed_stacked) {
 	if (!children->length) {
 		return;
 	}
@@ -60,13 +61,8 @@ static void apply_horiz_layout(list_t *children, struct wlr_box *parent) {
 		inner_gap = ws->gaps_inner;
 	}
 	// Descendants of tabbed/stacked containers don't have gaps
-	struct sway_container *temp = child;
-	while (temp) {
-		enum sway_container_layout layout = container_parent_layout(temp);
-		if (layout == L_TABBED || layout == L_STACKED) {
-			inner_gap = 0;
-		}
-		temp = temp->parent;
+	if (in_tabbed_stacked) {
+		inner_gap = 0;
 	}
 	double total_gap = fmin(inner_gap * (children->length - 1),
 		fmax(0, parent->width - MIN_SANE_W * children->length));
@@ -92,7 +88,8 @@ static void apply_horiz_layout(list_t *children, struct wlr_box *parent) {
 	}
 }
 
-static void apply_vert_layout(list_t *children, struct wlr_box *parent) {
+static void apply_vert_layout(list_t *children, struct wlr_box *parent,
+		bool in_tabbed_stacked) {
 	if (!children->length) {
 		return;
 	}
@@ -139,13 +136,8 @@ static void apply_vert_layout(list_t *children, struct wlr_box *parent) {
 		inner_gap = ws->gaps_inner;
 	}
 	// Descendants of tabbed/stacked containers don't have gaps
-	struct sway_container *temp = child;
-	while (temp) {
-		enum sway_container_layout layout = container_parent_layout(temp);
-		if (layout == L_TABBED || layout == L_STACKED) {
-			inner_gap = 0;
-		}
-		temp = temp->parent;
+	if (in_tabbed_stacked) {
+		inner_gap = 0;
 	}
 	double total_gap = fmin(inner_gap * (children->length - 1),
 		fmax(0, parent->height - MIN_SANE_H * children->length));
@@ -200,22 +192,25 @@ static void apply_stacked_layout(list_t *children, struct wlr_box *parent) {
 	}
 }
 
+static void arrange_subtree(struct sway_container *container, bool force_dirty);
+
 static void arrange_floating(list_t *floating) {
 	for (int i = 0; i < floating->length; ++i) {
 		struct sway_container *floater = floating->items[i];
-		arrange_container(floater);
+		arrange_subtree(floater, false);
 	}
 }
 
 static void arrange_children(list_t *children,
-		enum sway_container_layout layout, struct wlr_box *parent) {
+		enum sway_container_layout layout, struct wlr_box *parent,
+		bool in_tabbed_stacked) {
 	// Calculate x, y, width and height of children
 	switch (layout) {
 	case L_HORIZ:
-		apply_horiz_layout(children, parent);
+		apply_horiz_layout(children, parent, in_tabbed_stacked);
 		break;
 	case L_VERT:
-		apply_vert_layout(children, parent);
+		apply_vert_layout(children, parent, in_tabbed_stacked);
 		break;
 	case L_TABBED:
 		apply_tabbed_layout(children, parent);
@@ -224,30 +219,47 @@ static void arrange_children(list_t *children,
 		apply_stacked_layout(children, parent);
 		break;
 	case L_NONE:
-		apply_horiz_layout(children, parent);
+		apply_horiz_layout(children, parent, in_tabbed_stacked);
 		break;
 	}
 
 	// Recurse into child containers
 	for (int i = 0; i < children->length; ++i) {
 		struct sway_container *child = children->items[i];
-		arrange_container(child);
+		arrange_subtree(child, false);
 	}
 }
 
-void arrange_container(struct sway_container *container) {
-	if (config->reloading) {
-		return;
-	}
+/**
+ * Lay out the container and its descendants. Only the container the arrange
+ * was requested for is unconditionally marked dirty; descendants are only
+ * added to the next transaction if their state actually changed.
+ */
+static void arrange_subtree(struct sway_container *container, bool force_dirty) {
+	enum sway_container_layout parent_layout =
+		container_parent_layout(container);
+	container->in_tabbed_stacked = parent_layout == L_TABBED ||
+		parent_layout == L_STACKED ||
+		(container->parent && container->parent->in_tabbed_stacked);
+
 	if (container->view) {
 		view_autoconfigure(container->view);
+	} else {
+		struct wlr_box box;
+		container_get_box(container, &box);
+		arrange_children(container->children, container->layout, &box,
+				container->in_tabbed_stacked);
+	}
+	if (force_dirty || container_state_changed(container)) {
 		node_set_dirty(&container->node);
+	}
+}
+
+void arrange_container(struct sway_container *container) {
+	if (config->reloading) {
 		return;
 	}
-	struct wlr_box box;
-	container_get_box(container, &box);
-	arrange_children(container->children, container->layout, &box);
-	node_set_dirty(&container->node);
+	arrange_subtree(container, true);
 }
 
 void arrange_workspace(struct sway_workspace *workspace) {
@@ -302,7 +314,7 @@ void arrange_workspace(struct sway_workspace *workspace) {
 	} else {
 		struct wlr_box box;
 		workspace_get_box(workspace, &box);
-		arrange_children(workspace->tiling, workspace->layout, &box);
+		arrange_children(workspace->tiling, workspace->layout, &box, false);
 		arrange_floating(workspace->floating);
 	}
 }
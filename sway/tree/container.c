@@ -19,6 +19,7 @@
 #include "sway/tree/arrange.h"
 #include "sway/tree/view.h"
 #include "sway/tree/workspace.h"
+#include "hash_map.h"
 #include "list.h"
 #include "log.h"
 #include "stringop.h"
@@ -84,6 +85,19 @@ void container_destroy(struct sway_container *con) {
 	free(con);
 }
 
+/**
+ * Removes the container's marks from the mark index, without removing them
+ * from the container itself.
+ */
+static void container_unindex_marks(struct sway_container *con) {
+	for (int i = 0; i < con->marks->length; ++i) {
+		char *mark = con->marks->items[i];
+		if (hash_map_get(root->marks, mark) == con) {
+			hash_map_remove(root->marks, mark);
+		}
+	}
+}
+
 void container_begin_destroy(struct sway_container *con) {
 	if (con->view) {
 		ipc_event_window(con, "close");
@@ -115,6 +129,9 @@ void container_begin_destroy(struct sway_container *con) {
 	if (con->parent || con->workspace) {
 		container_detach(con);
 	}
+
+	// Destroying containers can't be found by their marks anymore
+	container_unindex_marks(con);
 }
 
 void container_reap_empty(struct sway_container *con) {
@@ -272,6 +289,32 @@ static struct sway_container *container_at_linear(struct sway_node *parent,
 		double lx, double ly,
 		struct wlr_surface **surface, double *sx, double *sy) {
 	list_t *children = node_get_children(parent);
+
+	// Once arranged, the children are laid out in list order along the split
+	// axis without overlapping, so the child under the point can be found by
+	// bisection instead of searching every subtree.
+	bool horiz = node_get_layout(parent) == L_HORIZ;
+	double pos = horiz ? lx : ly;
+	int lo = 0, hi = children->length;
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		struct sway_container *child = children->items[mid];
+		if ((horiz ? child->x : child->y) <= pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo > 0) {
+		struct sway_container *child = children->items[lo - 1];
+		double start = horiz ? child->x : child->y;
+		double size = horiz ? child->width : child->height;
+		if (pos < start + size) {
+			return tiling_container_at(&child->node, lx, ly, surface, sx, sy);
+		}
+	}
+
+	// The point is between children, or they haven't been arranged yet
 	for (int i = 0; i < children->length; ++i) {
 		struct sway_container *child = children->items[i];
 		struct sway_container *container =
@@ -509,6 +552,7 @@ static void update_title_texture(struct sway_container *con,
 			output->wlr_output->backend);
 	*texture = wlr_texture_from_pixels(
 			renderer, WL_SHM_FORMAT_ARGB8888, stride, width, height, data);
+	output->render_stats.texture_uploads++;
 	cairo_surface_destroy(surface);
 	g_object_unref(pango);
 	cairo_destroy(cairo);
@@ -523,7 +567,7 @@ void container_update_title_textures(struct sway_container *container) {
 			&config->border_colors.unfocused);
 	update_title_texture(container, &container->title_urgent,
 			&config->border_colors.urgent);
-	container_damage_whole(container);
+	desktop_damage_container_decorations(container);
 }
 
 void container_calculate_title_height(struct sway_container *container) {
@@ -1224,6 +1268,37 @@ void container_discover_outputs(struct sway_container *con) {
 	}
 }
 
+bool container_state_changed(struct sway_container *con) {
+	if (con->node.ntxnrefs > 0) {
+		return true;
+	}
+	struct sway_container_state *state = &con->current;
+	if (con->x != state->x || con->y != state->y ||
+			con->width != state->width || con->height != state->height ||
+			con->content_x != state->content_x ||
+			con->content_y != state->content_y ||
+			con->content_width != state->content_width ||
+			con->content_height != state->content_height) {
+		return true;
+	}
+	if (con->layout != state->layout ||
+			con->fullscreen_mode != state->fullscreen_mode ||
+			con->workspace != state->workspace ||
+			con->parent != state->parent ||
+			con->border != state->border ||
+			con->border_thickness != state->border_thickness ||
+			con->border_top != state->border_top ||
+			con->border_bottom != state->border_bottom ||
+			con->border_left != state->border_left ||
+			con->border_right != state->border_right) {
+		return true;
+	}
+	if (con->view) {
+		return false;
+	}
+	return !list_equal(con->children, state->children);
+}
+
 enum sway_container_layout container_parent_layout(struct sway_container *con) {
 	if (con->parent) {
 		return con->parent->layout;
@@ -1442,18 +1517,12 @@ bool container_is_transient_for(struct sway_container *child,
 		view_is_transient_for(child->view, ancestor->view);
 }
 
-static bool find_by_mark_iterator(struct sway_container *con, void *data) {
-	char *mark = data;
-	return container_has_mark(con, mark);
-}
-
 struct sway_container *container_find_mark(char *mark) {
-	return root_find_container(find_by_mark_iterator, mark);
+	return hash_map_get(root->marks, mark);
 }
 
 bool container_find_and_unmark(char *mark) {
-	struct sway_container *con = root_find_container(
-		find_by_mark_iterator, mark);
+	struct sway_container *con = hash_map_remove(root->marks, mark);
 	if (!con) {
 		return false;
 	}
@@ -1472,6 +1541,7 @@ bool container_find_and_unmark(char *mark) {
 }
 
 void container_clear_marks(struct sway_container *con) {
+	container_unindex_marks(con);
 	for (int i = 0; i < con->marks->length; ++i) {
 		free(con->marks->items[i]);
 	}
@@ -1480,17 +1550,17 @@ void container_clear_marks(struct sway_container *con) {
 }
 
 bool container_has_mark(struct sway_container *con, char *mark) {
-	for (int i = 0; i < con->marks->length; ++i) {
-		char *item = con->marks->items[i];
-		if (strcmp(item, mark) == 0) {
-			return true;
-		}
-	}
-	return false;
+	return hash_map_get(root->marks, mark) == con;
 }
 
 void container_add_mark(struct sway_container *con, char *mark) {
-	list_add(con->marks, strdup(mark));
+	char *copy = strdup(mark);
+	if (!copy || !hash_map_set(root->marks, mark, con)) {
+		sway_log(SWAY_ERROR, "Unable to allocate mark");
+		free(copy);
+		return;
+	}
+	list_add(con->marks, copy);
 	ipc_event_window(con, "mark");
 }
 
@@ -1562,6 +1632,7 @@ static void update_marks_texture(struct sway_container *con,
 			output->wlr_output->backend);
 	*texture = wlr_texture_from_pixels(
 			renderer, WL_SHM_FORMAT_ARGB8888, stride, width, height, data);
+	output->render_stats.texture_uploads++;
 	cairo_surface_destroy(surface);
 	g_object_unref(pango);
 	cairo_destroy(cairo);
@@ -1580,7 +1651,7 @@ void container_update_marks_textures(struct sway_container *con) {
 			&config->border_colors.unfocused);
 	update_marks_texture(con, &con->marks_urgent,
 			&config->border_colors.urgent);
-	container_damage_whole(con);
+	desktop_damage_container_decorations(con);
 }
 
 void container_raise_floating(struct sway_container *con) {
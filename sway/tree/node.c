@@ -12,6 +12,7 @@ void node_init(struct sway_node *node, enum sway_node_type type, void *thing) {
 	node->id = next_id++;
 	node->type = type;
 	node->sway_root = thing;
+	wl_list_init(&node->seat_nodes);
 	wl_signal_init(&node->events.destroy);
 }
 
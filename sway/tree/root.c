@@ -11,6 +11,7 @@
 #include "sway/tree/container.h"
 #include "sway/tree/root.h"
 #include "sway/tree/workspace.h"
+#include "hash_map.h"
 #include "list.h"
 #include "log.h"
 #include "util.h"
@@ -39,6 +40,7 @@ struct sway_root *root_create(void) {
 	wl_signal_init(&root->events.new_node);
 	root->outputs = create_list();
 	root->scratchpad = create_list();
+	root->marks = create_hash_map();
 
 	root->output_layout_change.notify = output_layout_handle_change;
 	wl_signal_add(&root->output_layout->events.change,
@@ -48,6 +50,7 @@ struct sway_root *root_create(void) {
 
 void root_destroy(struct sway_root *root) {
 	wl_list_remove(&root->output_layout_change.link);
+	hash_map_free(root->marks);
 	list_free(root->scratchpad);
 	list_free(root->outputs);
 	wlr_output_layout_destroy(root->output_layout);
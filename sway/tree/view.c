@@ -495,8 +495,9 @@ void view_execute_criteria(struct sway_view *view) {
 		sway_log(SWAY_DEBUG, "for_window '%s' matches view %p, cmd: '%s'",
 				criteria->raw, view, criteria->cmdlist);
 		list_add(view->executed_criteria, criteria);
-		list_t *res_list = execute_command(
-				criteria->cmdlist, NULL, view->container);
+		list_t *res_list = criteria->compiled_cmdlist ?
+			execute_cmd_list(criteria->compiled_cmdlist, NULL, view->container) :
+			execute_command(criteria->cmdlist, NULL, view->container);
 		while (res_list->length) {
 			struct cmd_results *res = res_list->items[0];
 			free_cmd_results(res);
@@ -1294,7 +1295,7 @@ void view_set_urgent(struct sway_view *view, bool enable) {
 			view->urgent_timer = NULL;
 		}
 	}
-	container_damage_whole(view->container);
+	desktop_damage_container_decorations(view->container);
 
 	ipc_event_window(view->container, "urgent");
 
@@ -30,13 +30,17 @@
 #include "wlr-layer-shell-unstable-v1-client-protocol.h"
 #include "xdg-output-unstable-v1-client-protocol.h"
 
+void free_workspace(struct swaybar_workspace *ws) {
+	wl_list_remove(&ws->link);
+	free(ws->name);
+	free(ws->label);
+	free(ws);
+}
+
 void free_workspaces(struct wl_list *list) {
 	struct swaybar_workspace *ws, *tmp;
 	wl_list_for_each_safe(ws, tmp, list, link) {
-		wl_list_remove(&ws->link);
-		free(ws->name);
-		free(ws->label);
-		free(ws);
+		free_workspace(ws);
 	}
 }
 
@@ -410,6 +414,11 @@ bool bar_setup(struct swaybar *bar, const char *socket_path) {
 
 	bar->ipc_socketfd = ipc_open_socket(socket_path);
 	bar->ipc_event_socketfd = ipc_open_socket(socket_path);
+	bar->ipc_events = ipc_connection_create(bar->ipc_event_socketfd);
+	if (!bar->ipc_events) {
+		sway_log(SWAY_ERROR, "Unable to allocate IPC connection");
+		return false;
+	}
 	if (!ipc_initialize(bar)) {
 		return false;
 	}
@@ -458,6 +467,7 @@ bool bar_setup(struct swaybar *bar, const char *socket_path) {
 	determine_bar_visibility(bar, false);
 
 	bar->badges = create_badges();
+	ipc_get_keyboard_layout(bar);
 
 	return true;
 }
@@ -511,7 +521,7 @@ void bar_run(struct swaybar *bar) {
 
 #if HAVE_TRAY
 	if (bar->tray) {
-		loop_add_fd(bar->eventloop, bar->tray->fd, POLLIN, tray_in, bar->tray->bus);
+		tray_add_fds(bar->tray);
 	}
 #endif
 	while (bar->running) {
@@ -548,6 +558,7 @@ void bar_teardown(struct swaybar *bar) {
 	if (bar->config) {
 		free_config(bar->config);
 	}
+	ipc_connection_destroy(bar->ipc_events);
 	close(bar->ipc_event_socketfd);
 	close(bar->ipc_socketfd);
 	if (bar->status) {
@@ -28,94 +28,196 @@ void i3bar_block_unref(struct i3bar_block *block) {
 	}
 }
 
-static void i3bar_parse_json(struct status_line *status,
-		struct json_object *json_array) {
-	struct i3bar_block *block, *tmp;
-	wl_list_for_each_safe(block, tmp, &status->blocks, link) {
-		wl_list_remove(&block->link);
-		i3bar_block_unref(block);
+/**
+ * Fill block from the fields of json. The strings are borrowed from json, so
+ * the block is only valid as long as json is, and can be compared against the
+ * previous blocks without allocating anything.
+ */
+static void i3bar_block_parse(json_object *json, struct i3bar_block *block) {
+	json_object *full_text, *short_text, *color, *min_width, *align, *urgent;
+	json_object *name, *instance, *separator, *separator_block_width;
+	json_object *background, *border, *border_top, *border_bottom;
+	json_object *border_left, *border_right, *markup;
+	json_object_object_get_ex(json, "full_text", &full_text);
+	json_object_object_get_ex(json, "short_text", &short_text);
+	json_object_object_get_ex(json, "color", &color);
+	json_object_object_get_ex(json, "min_width", &min_width);
+	json_object_object_get_ex(json, "align", &align);
+	json_object_object_get_ex(json, "urgent", &urgent);
+	json_object_object_get_ex(json, "name", &name);
+	json_object_object_get_ex(json, "instance", &instance);
+	json_object_object_get_ex(json, "markup", &markup);
+	json_object_object_get_ex(json, "separator", &separator);
+	json_object_object_get_ex(json, "separator_block_width", &separator_block_width);
+	json_object_object_get_ex(json, "background", &background);
+	json_object_object_get_ex(json, "border", &border);
+	json_object_object_get_ex(json, "border_top", &border_top);
+	json_object_object_get_ex(json, "border_bottom", &border_bottom);
+	json_object_object_get_ex(json, "border_left", &border_left);
+	json_object_object_get_ex(json, "border_right", &border_right);
+
+	memset(block, 0, sizeof(*block));
+	block->full_text = full_text ?
+		(char *)json_object_get_string(full_text) : NULL;
+	block->short_text = short_text ?
+		(char *)json_object_get_string(short_text) : NULL;
+	if (color) {
+		const char *hexstring = json_object_get_string(color);
+		block->color_set = parse_color(hexstring, &block->color);
+		if (!block->color_set) {
+			sway_log(SWAY_ERROR, "Invalid block color: %s", hexstring);
+		}
+	}
+	if (min_width) {
+		json_type type = json_object_get_type(min_width);
+		if (type == json_type_int) {
+			block->min_width = json_object_get_int(min_width);
+		} else if (type == json_type_string) {
+			/* the width will be calculated when rendering */
+			block->min_width_str = (char *)json_object_get_string(min_width);
+		}
+	}
+	block->align = align ? (char *)json_object_get_string(align) : "left";
+	block->urgent = urgent ? json_object_get_int(urgent) : false;
+	block->name = name ? (char *)json_object_get_string(name) : NULL;
+	block->instance = instance ?
+		(char *)json_object_get_string(instance) : NULL;
+	if (markup) {
+		block->markup = false;
+		const char *markup_str = json_object_get_string(markup);
+		if (strcmp(markup_str, "pango") == 0) {
+			block->markup = true;
+		}
 	}
+	block->separator = separator ? json_object_get_int(separator) : true;
+	block->separator_block_width = separator_block_width ?
+		json_object_get_int(separator_block_width) : 9;
+	// Airblader features
+	const char *hex = background ? json_object_get_string(background) : NULL;
+	if (hex && !parse_color(hex, &block->background)) {
+		sway_log(SWAY_ERROR, "Ignoring invalid block background: %s", hex);
+	}
+	hex = border ? json_object_get_string(border) : NULL;
+	if (hex && !parse_color(hex, &block->border)) {
+		sway_log(SWAY_ERROR, "Ignoring invalid block border: %s", hex);
+	}
+	block->border_top = border_top ? json_object_get_int(border_top) : 1;
+	block->border_bottom = border_bottom ?
+		json_object_get_int(border_bottom) : 1;
+	block->border_left = border_left ? json_object_get_int(border_left) : 1;
+	block->border_right = border_right ?
+		json_object_get_int(border_right) : 1;
+}
+
+static char *strdup_or_null(const char *str) {
+	return str ? strdup(str) : NULL;
+}
+
+// Make an owned copy of a block filled by i3bar_block_parse
+static struct i3bar_block *i3bar_block_create(const struct i3bar_block *parsed) {
+	struct i3bar_block *block = malloc(sizeof(struct i3bar_block));
+	*block = *parsed;
+	block->ref_count = 1;
+	block->full_text = strdup_or_null(parsed->full_text);
+	block->short_text = strdup_or_null(parsed->short_text);
+	block->align = strdup_or_null(parsed->align);
+	block->min_width_str = strdup_or_null(parsed->min_width_str);
+	block->name = strdup_or_null(parsed->name);
+	block->instance = strdup_or_null(parsed->instance);
+	return block;
+}
+
+static bool str_equal(const char *a, const char *b) {
+	return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+static bool i3bar_block_equal(struct i3bar_block *a, struct i3bar_block *b) {
+	return str_equal(a->full_text, b->full_text) &&
+		str_equal(a->short_text, b->short_text) &&
+		str_equal(a->align, b->align) &&
+		str_equal(a->min_width_str, b->min_width_str) &&
+		a->urgent == b->urgent &&
+		a->color_set == b->color_set &&
+		(!a->color_set || a->color == b->color) &&
+		a->min_width == b->min_width &&
+		a->separator == b->separator &&
+		a->separator_block_width == b->separator_block_width &&
+		a->markup == b->markup &&
+		a->background == b->background &&
+		a->border == b->border &&
+		a->border_top == b->border_top &&
+		a->border_bottom == b->border_bottom &&
+		a->border_left == b->border_left &&
+		a->border_right == b->border_right;
+}
+
+/**
+ * Replace the blocks of the status line with the blocks in json_array. Blocks
+ * are matched against the previous blocks by name and instance, and previous
+ * blocks which didn't change are kept without allocating a new block. Returns
+ * whether any block changed, so that status generators which repeat the same
+ * blocks don't cause redraws.
+ */
+static bool i3bar_parse_json(struct status_line *status,
+		struct json_object *json_array) {
+	struct wl_list old_blocks;
+	wl_list_init(&old_blocks);
+	wl_list_insert_list(&old_blocks, &status->blocks);
+	wl_list_init(&status->blocks);
+
+	// status->blocks is built by inserting at the head, so both it and
+	// old_blocks are in reverse json order. Old blocks are walked from the
+	// tail, and each match is removed, so that blocks without a name (which
+	// all match each other) are paired up by position. old_pos is the old
+	// block at the position of the current new block.
+	struct wl_list *old_pos = old_blocks.prev;
+	bool changed = false;
 	for (size_t i = 0; i < json_object_array_length(json_array); ++i) {
-		json_object *full_text, *short_text, *color, *min_width, *align, *urgent;
-		json_object *name, *instance, *separator, *separator_block_width;
-		json_object *background, *border, *border_top, *border_bottom;
-		json_object *border_left, *border_right, *markup;
 		json_object *json = json_object_array_get_idx(json_array, i);
 		if (!json) {
 			continue;
 		}
-		json_object_object_get_ex(json, "full_text", &full_text);
-		json_object_object_get_ex(json, "short_text", &short_text);
-		json_object_object_get_ex(json, "color", &color);
-		json_object_object_get_ex(json, "min_width", &min_width);
-		json_object_object_get_ex(json, "align", &align);
-		json_object_object_get_ex(json, "urgent", &urgent);
-		json_object_object_get_ex(json, "name", &name);
-		json_object_object_get_ex(json, "instance", &instance);
-		json_object_object_get_ex(json, "markup", &markup);
-		json_object_object_get_ex(json, "separator", &separator);
-		json_object_object_get_ex(json, "separator_block_width", &separator_block_width);
-		json_object_object_get_ex(json, "background", &background);
-		json_object_object_get_ex(json, "border", &border);
-		json_object_object_get_ex(json, "border_top", &border_top);
-		json_object_object_get_ex(json, "border_bottom", &border_bottom);
-		json_object_object_get_ex(json, "border_left", &border_left);
-		json_object_object_get_ex(json, "border_right", &border_right);
+		struct i3bar_block parsed;
+		i3bar_block_parse(json, &parsed);
 
-		struct i3bar_block *block = calloc(1, sizeof(struct i3bar_block));
-		block->ref_count = 1;
-		block->full_text = full_text ?
-			strdup(json_object_get_string(full_text)) : NULL;
-		block->short_text = short_text ?
-			strdup(json_object_get_string(short_text)) : NULL;
-		if (color) {
-			const char *hexstring = json_object_get_string(color);
-			block->color_set = parse_color(hexstring, &block->color);
-			if (!block->color_set) {
-				sway_log(SWAY_ERROR, "Invalid block color: %s", hexstring);
+		struct i3bar_block *old = NULL, *candidate;
+		wl_list_for_each_reverse(candidate, &old_blocks, link) {
+			if (str_equal(candidate->name, parsed.name) &&
+					str_equal(candidate->instance, parsed.instance)) {
+				old = candidate;
+				break;
 			}
 		}
-		if (min_width) {
-			json_type type = json_object_get_type(min_width);
-			if (type == json_type_int) {
-				block->min_width = json_object_get_int(min_width);
-			} else if (type == json_type_string) {
-				/* the width will be calculated when rendering */
-				block->min_width_str = strdup(json_object_get_string(min_width));
+
+		struct i3bar_block *block;
+		if (old) {
+			if (old_pos == &old->link) {
+				old_pos = old_pos->prev;
+			} else {
+				changed = true;
 			}
-		}
-		block->align = strdup(align ? json_object_get_string(align) : "left");
-		block->urgent = urgent ? json_object_get_int(urgent) : false;
-		block->name = name ? strdup(json_object_get_string(name)) : NULL;
-		block->instance = instance ?
-			strdup(json_object_get_string(instance)) : NULL;
-		if (markup) {
-			block->markup = false;
-			const char *markup_str = json_object_get_string(markup);
-			if (strcmp(markup_str, "pango") == 0) {
-				block->markup = true;
+			wl_list_remove(&old->link);
+			if (i3bar_block_equal(old, &parsed)) {
+				block = old;
+			} else {
+				changed = true;
+				i3bar_block_unref(old);
+				block = i3bar_block_create(&parsed);
 			}
+		} else {
+			changed = true;
+			block = i3bar_block_create(&parsed);
 		}
-		block->separator = separator ? json_object_get_int(separator) : true;
-		block->separator_block_width = separator_block_width ?
-			json_object_get_int(separator_block_width) : 9;
-		// Airblader features
-		const char *hex = background ? json_object_get_string(background) : NULL;
-		if (hex && !parse_color(hex, &block->background)) {
-			sway_log(SWAY_ERROR, "Ignoring invalid block background: %s", hex);
-		}
-		hex = border ? json_object_get_string(border) : NULL;
-		if (hex && !parse_color(hex, &block->border)) {
-			sway_log(SWAY_ERROR, "Ignoring invalid block border: %s", hex);
-		}
-		block->border_top = border_top ? json_object_get_int(border_top) : 1;
-		block->border_bottom = border_bottom ?
-			json_object_get_int(border_bottom) : 1;
-		block->border_left = border_left ? json_object_get_int(border_left) : 1;
-		block->border_right = border_right ?
-			json_object_get_int(border_right) : 1;
 		wl_list_insert(&status->blocks, &block->link);
 	}
+
+	struct i3bar_block *block, *tmp;
+	wl_list_for_each_safe(block, tmp, &old_blocks, link) {
+		changed = true;
+		wl_list_remove(&block->link);
+		i3bar_block_unref(block);
+	}
+	return changed;
 }
 
 bool i3bar_handle_readable(struct status_line *status) {
@@ -194,17 +296,19 @@ bool i3bar_handle_readable(struct status_line *status) {
 				// in order to print the json for debugging purposes
 				// the last character is temporarily replaced with a null character
 				// (the last character is used in case the buffer is full)
-				char *last_char_pos =
-					&status->buffer[buffer_pos + status->tokener->char_offset - 1];
-				char last_char = *last_char_pos;
-				while (isspace(last_char)) {
-					last_char = *--last_char_pos;
+				if (sway_log_get_verbosity() >= SWAY_DEBUG) {
+					char *last_char_pos =
+						&status->buffer[buffer_pos + status->tokener->char_offset - 1];
+					char last_char = *last_char_pos;
+					while (isspace(last_char)) {
+						last_char = *--last_char_pos;
+					}
+					*last_char_pos = '\0';
+					size_t offset = strspn(&status->buffer[buffer_pos], " \f\n\r\t\v");
+					sway_log(SWAY_DEBUG, "Received i3bar json: '%s%c'",
+							&status->buffer[buffer_pos + offset], last_char);
+					*last_char_pos = last_char;
 				}
-				*last_char_pos = '\0';
-				size_t offset = strspn(&status->buffer[buffer_pos], " \f\n\r\t\v");
-				sway_log(SWAY_DEBUG, "Received i3bar json: '%s%c'",
-						&status->buffer[buffer_pos + offset], last_char);
-				*last_char_pos = last_char;
 
 				buffer_pos += status->tokener->char_offset;
 				status->expecting_comma = true;
@@ -257,10 +361,12 @@ bool i3bar_handle_readable(struct status_line *status) {
 	}
 
 	if (last_object) {
-		sway_log(SWAY_DEBUG, "Rendering last received json");
-		i3bar_parse_json(status, last_object);
+		bool changed = i3bar_parse_json(status, last_object);
 		json_object_put(last_object);
-		return true;
+		if (changed) {
+			sway_log(SWAY_DEBUG, "Rendering last received json");
+		}
+		return changed;
 	} else {
 		return false;
 	}
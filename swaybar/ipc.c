@@ -2,12 +2,14 @@
 #include <limits.h>
 #include <poll.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <json.h>
 #include "swaybar/config.h"
 #include "swaybar/ipc.h"
 #include "swaybar/status_line.h"
+#include "swaybar/system_info.h"
 #if HAVE_TRAY
 #include "swaybar/tray/tray.h"
 #endif
@@ -329,6 +331,60 @@ static bool ipc_parse_config(
 	return true;
 }
 
+static struct swaybar_output *find_output(struct swaybar *bar,
+		json_object *ws_json) {
+	json_object *out;
+	json_object_object_get_ex(ws_json, "output", &out);
+	const char *ws_output = json_object_get_string(out);
+	if (!ws_output) {
+		return NULL;
+	}
+	struct swaybar_output *output;
+	wl_list_for_each(output, &bar->outputs, link) {
+		if (strcmp(ws_output, output->name) == 0) {
+			return output;
+		}
+	}
+	return NULL;
+}
+
+static struct swaybar_workspace *create_workspace(struct swaybar *bar,
+		json_object *ws_json) {
+	json_object *id, *num, *name, *visible, *focused, *urgent;
+	json_object_object_get_ex(ws_json, "id", &id);
+	json_object_object_get_ex(ws_json, "num", &num);
+	json_object_object_get_ex(ws_json, "name", &name);
+	json_object_object_get_ex(ws_json, "visible", &visible);
+	json_object_object_get_ex(ws_json, "focused", &focused);
+	json_object_object_get_ex(ws_json, "urgent", &urgent);
+
+	struct swaybar_workspace *ws = calloc(1, sizeof(struct swaybar_workspace));
+	ws->id = json_object_get_int(id);
+	ws->num = json_object_get_int(num);
+	ws->name = strdup(json_object_get_string(name));
+	ws->label = strdup(ws->name);
+	// ws->num will be -1 if workspace name doesn't begin with int.
+	if (ws->num != -1) {
+		size_t len_offset = snprintf(NULL, 0, "%d", ws->num);
+		if (bar->config->strip_workspace_name) {
+			free(ws->label);
+			ws->label = malloc(len_offset + 1);
+			snprintf(ws->label, len_offset + 1, "%d", ws->num);
+		} else if (bar->config->strip_workspace_numbers) {
+			len_offset += ws->label[len_offset] == ':';
+			if (ws->name[len_offset] != '\0') {
+				free(ws->label);
+				// Strip number prefix [1-?:] using len_offset.
+				ws->label = strdup(ws->name + len_offset);
+			}
+		}
+	}
+	ws->visible = json_object_get_boolean(visible);
+	ws->focused = json_object_get_boolean(focused);
+	ws->urgent = json_object_get_boolean(urgent);
+	return ws;
+}
+
 bool ipc_get_workspaces(struct swaybar *bar) {
 	struct swaybar_output *output;
 	wl_list_for_each(output, &bar->outputs, link) {
@@ -346,60 +402,166 @@ bool ipc_get_workspaces(struct swaybar *bar) {
 
 	bar->visible_by_urgency = false;
 	size_t length = json_object_array_length(results);
-	json_object *ws_json;
-	json_object *num, *name, *visible, *focused, *out, *urgent;
 	for (size_t i = 0; i < length; ++i) {
-		ws_json = json_object_array_get_idx(results, i);
-
-		json_object_object_get_ex(ws_json, "num", &num);
-		json_object_object_get_ex(ws_json, "name", &name);
-		json_object_object_get_ex(ws_json, "visible", &visible);
-		json_object_object_get_ex(ws_json, "focused", &focused);
-		json_object_object_get_ex(ws_json, "output", &out);
-		json_object_object_get_ex(ws_json, "urgent", &urgent);
-
-		wl_list_for_each(output, &bar->outputs, link) {
-			const char *ws_output = json_object_get_string(out);
-			if (ws_output != NULL && strcmp(ws_output, output->name) == 0) {
-				struct swaybar_workspace *ws =
-					calloc(1, sizeof(struct swaybar_workspace));
-				ws->num = json_object_get_int(num);
-				ws->name = strdup(json_object_get_string(name));
-				ws->label = strdup(ws->name);
-				// ws->num will be -1 if workspace name doesn't begin with int.
-				if (ws->num != -1) {
-					size_t len_offset = snprintf(NULL, 0, "%d", ws->num);
-					if (bar->config->strip_workspace_name) {
-						free(ws->label);
-						ws->label = malloc(len_offset + 1);
-						snprintf(ws->label, len_offset + 1, "%d", ws->num);
-					} else if (bar->config->strip_workspace_numbers) {
-						len_offset += ws->label[len_offset] == ':';
-						if (ws->name[len_offset] != '\0') {
-							free(ws->label);
-							// Strip number prefix [1-?:] using len_offset.
-							ws->label = strdup(ws->name + len_offset);
-						}
-					}
-				}
-				ws->visible = json_object_get_boolean(visible);
-				ws->focused = json_object_get_boolean(focused);
-				if (ws->focused) {
-					output->focused = true;
-				}
-				ws->urgent = json_object_get_boolean(urgent);
-				if (ws->urgent) {
-					bar->visible_by_urgency = true;
-				}
-				wl_list_insert(output->workspaces.prev, &ws->link);
-			}
+		json_object *ws_json = json_object_array_get_idx(results, i);
+		output = find_output(bar, ws_json);
+		if (!output) {
+			continue;
+		}
+		struct swaybar_workspace *ws = create_workspace(bar, ws_json);
+		if (ws->focused) {
+			output->focused = true;
+		}
+		if (ws->urgent) {
+			bar->visible_by_urgency = true;
 		}
+		wl_list_insert(output->workspaces.prev, &ws->link);
 	}
 	json_object_put(results);
 	free(res);
 	return determine_bar_visibility(bar, false);
 }
 
+static struct swaybar_workspace *find_workspace(struct swaybar *bar,
+		json_object *ws_json, struct swaybar_output **output) {
+	json_object *json_id;
+	if (!json_object_object_get_ex(ws_json, "id", &json_id)) {
+		return NULL;
+	}
+	int id = json_object_get_int(json_id);
+	struct swaybar_output *out;
+	wl_list_for_each(out, &bar->outputs, link) {
+		struct swaybar_workspace *ws;
+		wl_list_for_each(ws, &out->workspaces, link) {
+			if (ws->id == id) {
+				if (output) {
+					*output = out;
+				}
+				return ws;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Insert the workspace where sway sorts it: numbered workspaces in order of
+ * their number, followed by the others in the order they were created.
+ */
+static void insert_workspace(struct swaybar_output *output,
+		struct swaybar_workspace *ws) {
+	struct swaybar_workspace *other;
+	if (ws->num != -1) {
+		wl_list_for_each(other, &output->workspaces, link) {
+			if (other->num == -1 || other->num > ws->num) {
+				wl_list_insert(other->link.prev, &ws->link);
+				return;
+			}
+		}
+	}
+	wl_list_insert(output->workspaces.prev, &ws->link);
+}
+
+static void update_visible_by_urgency(struct swaybar *bar) {
+	bar->visible_by_urgency = false;
+	struct swaybar_output *output;
+	wl_list_for_each(output, &bar->outputs, link) {
+		struct swaybar_workspace *ws;
+		wl_list_for_each(ws, &output->workspaces, link) {
+			if (ws->urgent) {
+				bar->visible_by_urgency = true;
+				return;
+			}
+		}
+	}
+}
+
+static void handle_workspace_focus(struct swaybar *bar,
+		struct swaybar_output *focused_output,
+		struct swaybar_workspace *focused) {
+	struct swaybar_output *output;
+	wl_list_for_each(output, &bar->outputs, link) {
+		output->focused = output == focused_output;
+		struct swaybar_workspace *ws;
+		wl_list_for_each(ws, &output->workspaces, link) {
+			ws->focused = ws == focused;
+			if (output == focused_output) {
+				ws->visible = ws == focused;
+			}
+		}
+	}
+}
+
+/**
+ * Apply a workspace event to the workspace list using the workspace described
+ * in the event. Changes which can't be applied this way, such as renames and
+ * moves which reorder the list, set refetch so that all workspaces are fetched
+ * once the pending events have been handled.
+ */
+static bool handle_workspace_event(struct swaybar *bar, json_object *event,
+		bool *refetch) {
+	json_object *json_change, *current;
+	if (!json_object_object_get_ex(event, "change", &json_change) ||
+			!json_object_object_get_ex(event, "current", &current) ||
+			!current) {
+		*refetch = true;
+		return true;
+	}
+	const char *change = json_object_get_string(json_change);
+	struct swaybar_output *output = NULL;
+	struct swaybar_workspace *ws = find_workspace(bar, current, &output);
+
+	if (strcmp(change, "init") == 0) {
+		if (ws) {
+			*refetch = true;
+			return true;
+		}
+		output = find_output(bar, current);
+		if (!output) {
+			return false;
+		}
+		ws = create_workspace(bar, current);
+		// A workspace created without being focused is only visible if it's
+		// the first one on its output
+		bool visible = true;
+		struct swaybar_workspace *other;
+		wl_list_for_each(other, &output->workspaces, link) {
+			visible = visible && !other->visible;
+		}
+		ws->visible = visible;
+		ws->focused = false;
+		insert_workspace(output, ws);
+	} else if (strcmp(change, "empty") == 0) {
+		if (!ws) {
+			return false;
+		}
+		free_workspace(ws);
+	} else if (strcmp(change, "focus") == 0) {
+		if (!ws) {
+			if (find_output(bar, current)) {
+				*refetch = true;
+				return true;
+			}
+			// Focus moved to an output without this bar
+			handle_workspace_focus(bar, NULL, NULL);
+		} else {
+			handle_workspace_focus(bar, output, ws);
+		}
+	} else if (strcmp(change, "urgent") == 0) {
+		if (!ws) {
+			return false;
+		}
+		json_object *urgent;
+		json_object_object_get_ex(current, "urgent", &urgent);
+		ws->urgent = json_object_get_boolean(urgent);
+	} else {
+		*refetch = true;
+		return true;
+	}
+	update_visible_by_urgency(bar);
+	return determine_bar_visibility(bar, false);
+}
+
 void ipc_execute_binding(struct swaybar *bar, struct swaybar_binding *bind) {
 	sway_log(SWAY_DEBUG, "Executing binding for button %u (release=%d): `%s`",
 			bind->button, bind->release, bind->command);
@@ -419,16 +581,26 @@ bool ipc_initialize(struct swaybar *bar) {
 	free(res);
 
 	struct swaybar_config *config = bar->config;
-	char subscribe[128]; // suitably large buffer
-	len = snprintf(subscribe, 128,
-			"[ \"barconfig_update\" , \"bar_state_update\" %s %s ]",
+	char subscribe[256]; // suitably large buffer
+	// input events are for the keyboard layout badge
+	len = snprintf(subscribe, sizeof(subscribe),
+			"[ \"barconfig_update\" , \"bar_state_update\" , \"input\" %s %s ]",
 			config->binding_mode_indicator ? ", \"mode\"" : "",
-			config->workspace_buttons ? ", \"workspace\"" : "");
+			config->workspace_buttons ?
+				", { \"event\": \"workspace\", \"shallow\": true }" : "");
 	free(ipc_single_command(bar->ipc_event_socketfd,
 			IPC_SUBSCRIBE, subscribe, &len));
 	return true;
 }
 
+void ipc_get_keyboard_layout(struct swaybar *bar) {
+	uint32_t len = 0;
+	char *res = ipc_single_command(bar->ipc_socketfd,
+			IPC_GET_INPUTS, NULL, &len);
+	keyboard_layout_handle_get_inputs(res);
+	free(res);
+}
+
 static bool handle_bar_state_update(struct swaybar *bar, json_object *event) {
 	json_object *json_id;
 	json_object_object_get_ex(event, "id", &json_id);
@@ -515,10 +687,9 @@ static bool handle_barconfig_update(struct swaybar *bar, const char *payload,
 #if HAVE_TRAY
 	if (oldcfg->tray_hidden && !newcfg->tray_hidden) {
 		bar->tray = create_tray(bar);
-		loop_add_fd(bar->eventloop, bar->tray->fd, POLLIN, tray_in,
-				bar->tray->bus);
+		tray_add_fds(bar->tray);
 	} else if (bar->tray && newcfg->tray_hidden) {
-		loop_remove_fd(bar->eventloop, bar->tray->fd);
+		tray_remove_fds(bar->tray);
 		destroy_tray(bar->tray);
 		bar->tray = NULL;
 	}
@@ -535,23 +706,24 @@ static bool handle_barconfig_update(struct swaybar *bar, const char *payload,
 	return true;
 }
 
-bool handle_ipc_readable(struct swaybar *bar) {
-	struct ipc_response *resp = ipc_recv_response(bar->ipc_event_socketfd);
-	if (!resp) {
-		return false;
+static bool handle_ipc_event(struct swaybar *bar, uint32_t type,
+		const char *payload, bool *refetch) {
+	if (type == IPC_EVENT_INPUT) {
+		// Most input events are irrelevant, let the badge filter them
+		// before parsing
+		return keyboard_layout_handle_input_event(payload);
 	}
 
-	json_object *result = json_tokener_parse(resp->payload);
+	json_object *result = json_tokener_parse(payload);
 	if (!result) {
 		sway_log(SWAY_ERROR, "failed to parse payload as json");
-		free_ipc_response(resp);
 		return false;
 	}
 
 	bool bar_is_dirty = true;
-	switch (resp->type) {
+	switch (type) {
 	case IPC_EVENT_WORKSPACE:
-		bar_is_dirty = ipc_get_workspaces(bar);
+		bar_is_dirty = handle_workspace_event(bar, result, refetch);
 		break;
 	case IPC_EVENT_MODE: {
 		json_object *json_change, *json_pango_markup;
@@ -573,7 +745,7 @@ bool handle_ipc_readable(struct swaybar *bar) {
 		break;
 	}
 	case IPC_EVENT_BARCONFIG_UPDATE:
-		bar_is_dirty = handle_barconfig_update(bar, resp->payload, result);
+		bar_is_dirty = handle_barconfig_update(bar, payload, result);
 		break;
 	case IPC_EVENT_BAR_STATE_UPDATE:
 		bar_is_dirty = handle_bar_state_update(bar, result);
@@ -583,6 +755,25 @@ bool handle_ipc_readable(struct swaybar *bar) {
 		break;
 	}
 	json_object_put(result);
-	free_ipc_response(resp);
+	return bar_is_dirty;
+}
+
+bool handle_ipc_readable(struct swaybar *bar) {
+	// Handle every event which is available, so that a burst of events
+	// results in a single frame
+	if (!ipc_connection_read(bar->ipc_events)) {
+		sway_abort("Unable to receive IPC response");
+	}
+
+	bool bar_is_dirty = false;
+	bool refetch = false;
+	struct ipc_message msg;
+	while (ipc_connection_next(bar->ipc_events, &msg)) {
+		bar_is_dirty |= handle_ipc_event(bar, msg.type, msg.payload, &refetch);
+	}
+
+	if (refetch) {
+		bar_is_dirty |= ipc_get_workspaces(bar);
+	}
 	return bar_is_dirty;
 }
@@ -7,7 +7,6 @@
 #include <sys/types.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
-#include <sys/un.h>
 #include <unistd.h>
 #include <math.h>
 #include <json.h>
@@ -288,122 +287,28 @@ int get_network_status(char* buffer, size_t max,
 	return 0;
 }
 
-#pragma pack(push, 1)
-struct i3_ipc_header_t {
-	char magic[6];
-	uint32_t len;
-	uint32_t kind;
-};
-#pragma pack(pop)
-
-struct ipc_session_t {
-	int fd;
-};
-
 struct keyboard_layout_provider_t {
-	struct ipc_session_t session;
 #define KLP_LAYOUT_MAX_LEN (64)
 	char layout_id[KLP_LAYOUT_MAX_LEN];
 };
 
-#define MESSAGE_SUBSCRIBE   (0x00000002)
-#define MESSAGE_GET_INPUTS  (0x00000064)
-#define EVENT_INPUT         (0x80000015)
-
-static int init_session(struct ipc_session_t *session) {
-	struct sockaddr_un addr;
-	const char *path = getenv("SWAYSOCK");
-	int fd;
-	int rc;
-
-	session->fd = -1;
-
-	if(path == NULL) {
-		sway_log(SWAY_ERROR, "getenv(SWAYSOCK) failed\n");
-		return 0;
-	}
-
-	fd = socket(AF_UNIX, SOCK_STREAM, 0);
-
-	if(fd == -1) {
-		sway_log_errno(SWAY_ERROR, "couldn't open new socket");
-		return 0;
-	}
-
-	memset(&addr, 0, sizeof(addr));
-	addr.sun_family = AF_UNIX;
-	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
-	rc = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
-
-	if(rc != 0) {
-		sway_log_errno(SWAY_ERROR, "couldn't connect()");
-		close(fd);
-		return 0;
-	}
-
-	session->fd = fd;
-	return 1;
-}
-
-static void teardown_session(struct ipc_session_t *session) {
-	if(session->fd >= 0) {
-		close(session->fd);
-		session->fd = -1;
-	}
-}
-
-static int ipc_subscribe(struct ipc_session_t *session, const char *name) {
-	char buf[128];
-	size_t idx = snprintf(buf, 127, "[\"%s\"]", name);
-	ssize_t rc;
-
-	struct i3_ipc_header_t hdr;
-	hdr.magic[0] = 'i'; hdr.magic[1] = '3'; hdr.magic[2] = '-';
-	hdr.magic[3] = 'i'; hdr.magic[4] = 'p'; hdr.magic[5] = 'c';
-	hdr.len = idx;
-	hdr.kind = MESSAGE_SUBSCRIBE;
-
-	rc  = write(session->fd, &hdr, sizeof(hdr));
-	rc += write(session->fd, buf, idx);
-
-	return (rc == (ssize_t)(sizeof(hdr) + idx));
-}
-
-static int ipc_empty_command(struct ipc_session_t *session, uint32_t kind) {
-	struct i3_ipc_header_t hdr;
-	ssize_t rc;
-	hdr.magic[0] = 'i'; hdr.magic[1] = '3'; hdr.magic[2] = '-';
-	hdr.magic[3] = 'i'; hdr.magic[4] = 'p'; hdr.magic[5] = 'c';
-	hdr.len = 0;
-	hdr.kind = kind;
-
-	rc = write(session->fd, &hdr, sizeof(hdr));
-
-	return rc == sizeof(hdr);
-}
+// Input events arrive on swaybar's event socket, which the badges have no
+// access to, so they are handed to the provider through this pointer
+static struct keyboard_layout_provider_t *active_klp = NULL;
 
 struct keyboard_layout_provider_t* create_keyboard_layout_provider() {
 	struct keyboard_layout_provider_t *ret;
 
+	if(active_klp != NULL) {
+		sway_log(SWAY_ERROR, "keyboard layout provider already exists\n");
+		return NULL;
+	}
+
 	ret = malloc(sizeof(*ret));
 
 	if(ret != NULL) {
-		if(!init_session(&ret->session)) {
-			sway_log(SWAY_ERROR, "init_session() failed\n");
-			free(ret);
-			ret = NULL;
-		}
-
-		if(!ipc_subscribe(&ret->session, "input")) {
-			sway_log(SWAY_ERROR, "ipc_subscribe() failed\n");
-			teardown_session(&ret->session);
-			free(ret);
-			ret = NULL;
-		}
-
 		ret->layout_id[0] = 0;
-
-		ipc_empty_command(&ret->session, MESSAGE_GET_INPUTS);
+		active_klp = ret;
 	}
 
 	return ret;
@@ -411,33 +316,52 @@ struct keyboard_layout_provider_t* create_keyboard_layout_provider() {
 
 void destroy_keyboard_layout_provider(struct keyboard_layout_provider_t* klp) {
 	if(klp != NULL) {
-		teardown_session(&klp->session);
+		if(active_klp == klp) {
+			active_klp = NULL;
+		}
 		free(klp);
 	}
 }
 
-static void process_input_object(struct keyboard_layout_provider_t *klp,
+static int process_input_object(struct keyboard_layout_provider_t *klp,
 		struct json_object *input) {
 	struct json_object *xkb_active_layout_name;
 	if(!json_object_object_get_ex(input,
 				"xkb_active_layout_name", &xkb_active_layout_name)) {
 		sway_log(SWAY_DEBUG, "xkb_active_layout_name was NULL\n");
-		return;
+		return 0;
 	}
 
 	const char* layout = json_object_get_string(xkb_active_layout_name);
 	if(layout == NULL) {
 		sway_log(SWAY_DEBUG, "layout was NULL\n");
-		return;
+		return 0;
 	}
 
+	if(strncmp(klp->layout_id, layout, KLP_LAYOUT_MAX_LEN-1) == 0) {
+		return 0;
+	}
 	strncpy(klp->layout_id, layout, KLP_LAYOUT_MAX_LEN-1);
+	klp->layout_id[KLP_LAYOUT_MAX_LEN-1] = 0;
+	return 1;
 }
-static void process_input_event(struct keyboard_layout_provider_t *klp,
-		const char* payload) {
+
+int keyboard_layout_handle_input_event(const char *payload) {
 	struct json_object *root;
 	struct json_object *changed;
 	struct json_object *input;
+	int ret = 0;
+
+	if(active_klp == NULL) {
+		return 0;
+	}
+
+	// Only xkb_layout changes are interesting, skip parsing the others.
+	// Other changes can't contain this string, as the input's keys are
+	// longer than it (xkb_layout_names) and names are escaped.
+	if(strstr(payload, "\"xkb_layout\"") == NULL) {
+		return 0;
+	}
 
 	root = json_tokener_parse(payload);
 
@@ -460,17 +384,22 @@ static void process_input_event(struct keyboard_layout_provider_t *klp,
 			goto free_root;
 		}
 
-		process_input_object(klp, input);
+		ret = process_input_object(active_klp, input);
 
 free_root:
 		json_object_put(root);
 	}
+
+	return ret;
 }
 
-static void process_get_inputs_reply(struct keyboard_layout_provider_t *klp,
-		const char* payload) {
+void keyboard_layout_handle_get_inputs(const char *payload) {
 	struct json_object *root;
 
+	if(active_klp == NULL) {
+		return;
+	}
+
 	root = json_tokener_parse(payload);
 
 	if(root != NULL) {
@@ -489,64 +418,15 @@ static void process_get_inputs_reply(struct keyboard_layout_provider_t *klp,
 			if(type_s == NULL) continue;
 
 			if(strcmp(type_s, "keyboard") == 0) {
-				process_input_object(klp, cur);
+				process_input_object(active_klp, cur);
 			}
 		}
 		json_object_put(root);
 	}
 }
 
-static void process_message(struct keyboard_layout_provider_t *klp,
-		struct i3_ipc_header_t* hdr, const char* payload) {
-	switch(hdr->kind) {
-		case EVENT_INPUT:
-		sway_log(SWAY_DEBUG,
-				"incoming EVENT message packet len=%u\n", hdr->len);
-		process_input_event(klp, payload);
-		break;
-		case MESSAGE_GET_INPUTS:
-		sway_log(SWAY_DEBUG,
-				"incoming GET INPUTS reply packet len=%u\n", hdr->len);
-		process_get_inputs_reply(klp, payload);
-		break;
-		default:
-		sway_log(SWAY_DEBUG,
-				"incoming ipc packet of kind %u len=%u was ignored\n",
-				hdr->kind, hdr->len);
-		break;
-	}
-}
-
-static void read_messages(struct keyboard_layout_provider_t *klp) {
-	int bytes_avail;
-	int rc;
-	ssize_t rd;
-	struct i3_ipc_header_t hdr;
-	char* payload;
-	do {
-		bytes_avail = 0;
-		if((rc = ioctl(klp->session.fd, FIONREAD, &bytes_avail)) == 0) {
-			if(bytes_avail > 0) {
-				rd = read(klp->session.fd, &hdr, sizeof(hdr));
-				if(rd == sizeof(hdr)) {
-					payload = malloc(hdr.len + 1);
-					rd = read(klp->session.fd, payload, hdr.len);
-					payload[hdr.len] = 0;
-					if(rd == hdr.len) {
-						process_message(klp, &hdr, payload);
-					}
-					free(payload);
-				}
-			}
-		} else {
-			sway_log(SWAY_DEBUG, "ioctl failed rc=%d\n", rc);
-		}
-	} while(bytes_avail > 0);
-}
-
 const char* get_current_keyboard_layout(struct keyboard_layout_provider_t* klp) {
 	if(klp != NULL) {
-		read_messages(klp);
 		return klp->layout_id;
 	}
 
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 #include <wordexp.h>
 #include "swaybar/tray/icon.h"
@@ -63,10 +64,242 @@ static list_t *get_basedirs(void) {
 	return basedirs_expanded;
 }
 
+/*
+ * Instead of probing the filesystem for every subdir and extension on each
+ * lookup, the icon directories of a theme are listed once per basedir and
+ * lookups are a hash map probe. As suggested by the implementation notes of
+ * the icon theme spec, the directories are checked for changes at most every
+ * few seconds, and the index is rebuilt when one of them changed.
+ */
+#define INDEX_CHECK_INTERVAL 5 // seconds
+
+static const char *extensions[] = {
+#if HAVE_GDK_PIXBUF
+	"svg",
+#endif
+	"png",
+#if HAVE_GDK_PIXBUF
+	"xpm" // deprecated
+#endif
+};
+
+struct icon_theme_icon {
+	struct icon_theme_subdir *subdir;
+	size_t extension; // index into extensions, lower is preferred
+	char path[];
+};
+
+struct icon_theme_index_dir {
+	char *path;
+	struct timespec mtime; // zero if the directory didn't exist
+};
+
+struct icon_theme_index {
+	// icon name -> list_t of struct icon_theme_icon *, in search order
+	hash_map_t *icons;
+	list_t *dirs; // struct icon_theme_index_dir *
+	time_t last_check;
+};
+
+static time_t monotonic_seconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec;
+}
+
+static void free_icon_list(const char *key, void *value, void *data) {
+	list_free_items_and_destroy(value);
+}
+
+static void destroy_index(struct icon_theme_index *index) {
+	if (!index) {
+		return;
+	}
+	hash_map_for_each(index->icons, free_icon_list, NULL);
+	hash_map_free(index->icons);
+	for (int i = 0; i < index->dirs->length; ++i) {
+		struct icon_theme_index_dir *dir = index->dirs->items[i];
+		free(dir->path);
+		free(dir);
+	}
+	list_free(index->dirs);
+	free(index);
+}
+
+static void destroy_index_iterator(const char *key, void *value, void *data) {
+	destroy_index(value);
+}
+
+static DIR *open_index_dir(struct icon_theme_index *index, char *path) {
+	struct icon_theme_index_dir *dir =
+		calloc(1, sizeof(struct icon_theme_index_dir));
+	if (!dir) {
+		return NULL;
+	}
+	dir->path = path;
+	list_add(index->dirs, dir);
+
+	struct stat sb;
+	if (stat(path, &sb) != 0 || !S_ISDIR(sb.st_mode)) {
+		return NULL;
+	}
+	dir->mtime = sb.st_mtim;
+	return opendir(path);
+}
+
+static void index_subdir(struct icon_theme_index *index, char *basedir,
+		char *theme_dir, struct icon_theme_subdir *subdir) {
+	size_t path_len = snprintf(NULL, 0, "%s/%s/%s", basedir, theme_dir,
+			subdir->name) + 1;
+	char *path = malloc(path_len);
+	if (!path) {
+		return;
+	}
+	snprintf(path, path_len, "%s/%s/%s", basedir, theme_dir, subdir->name);
+	DIR *dir = open_index_dir(index, path);
+	if (!dir) {
+		return;
+	}
+
+	struct dirent *entry;
+	while ((entry = readdir(dir))) {
+		char *dot = strrchr(entry->d_name, '.');
+		if (!dot || dot == entry->d_name) {
+			continue;
+		}
+		size_t ext = 0;
+		for (; ext < sizeof(extensions) / sizeof(*extensions); ++ext) {
+			if (strcmp(dot + 1, extensions[ext]) == 0) {
+				break;
+			}
+		}
+		if (ext == sizeof(extensions) / sizeof(*extensions)) {
+			continue;
+		}
+
+		size_t icon_path_len = snprintf(NULL, 0, "%s/%s", path,
+				entry->d_name) + 1;
+		struct icon_theme_icon *icon =
+			malloc(sizeof(struct icon_theme_icon) + icon_path_len);
+		if (!icon) {
+			continue;
+		}
+		icon->subdir = subdir;
+		icon->extension = ext;
+		snprintf(icon->path, icon_path_len, "%s/%s", path, entry->d_name);
+
+		*dot = '\0';
+		list_t *icons = hash_map_get(index->icons, entry->d_name);
+		if (!icons) {
+			icons = create_list();
+			if (!hash_map_set(index->icons, entry->d_name, icons)) {
+				list_free(icons);
+				free(icon);
+				continue;
+			}
+		}
+		// Subdirs are listed one after the other, so another extension of
+		// this icon in the same subdir can only be the last one in the list
+		struct icon_theme_icon *last = icons->length > 0 ?
+			icons->items[icons->length - 1] : NULL;
+		if (last && last->subdir == subdir) {
+			if (ext < last->extension) {
+				icons->items[icons->length - 1] = icon;
+				free(last);
+			} else {
+				free(icon);
+			}
+		} else {
+			list_add(icons, icon);
+		}
+	}
+	closedir(dir);
+}
+
+static struct icon_theme_index *create_index(struct icon_theme *theme,
+		char *basedir) {
+	struct icon_theme_index *index = calloc(1, sizeof(struct icon_theme_index));
+	if (!index) {
+		return NULL;
+	}
+	index->icons = create_hash_map();
+	index->dirs = create_list();
+	index->last_check = monotonic_seconds();
+	if (!index->icons) {
+		destroy_index(index);
+		return NULL;
+	}
+
+	size_t path_len = snprintf(NULL, 0, "%s/%s", basedir, theme->dir) + 1;
+	char *path = malloc(path_len);
+	if (!path) {
+		return index;
+	}
+	snprintf(path, path_len, "%s/%s", basedir, theme->dir);
+	DIR *dir = open_index_dir(index, path);
+	if (!dir) {
+		// The theme isn't in this basedir, only watch for it being created
+		return index;
+	}
+	closedir(dir);
+
+	// search backwards to hopefully hit scalable/larger icons first
+	for (int j = theme->subdirs->length - 1; j >= 0; --j) {
+		index_subdir(index, basedir, theme->dir, theme->subdirs->items[j]);
+	}
+	return index;
+}
+
+static bool index_is_stale(struct icon_theme_index *index) {
+	time_t now = monotonic_seconds();
+	if (now - index->last_check < INDEX_CHECK_INTERVAL) {
+		return false;
+	}
+	index->last_check = now;
+
+	for (int i = 0; i < index->dirs->length; ++i) {
+		struct icon_theme_index_dir *dir = index->dirs->items[i];
+		struct stat sb;
+		struct timespec mtime = {0};
+		if (stat(dir->path, &sb) == 0 && S_ISDIR(sb.st_mode)) {
+			mtime = sb.st_mtim;
+		}
+		if (mtime.tv_sec != dir->mtime.tv_sec ||
+				mtime.tv_nsec != dir->mtime.tv_nsec) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static struct icon_theme_index *get_index(struct icon_theme *theme,
+		char *basedir) {
+	struct icon_theme_index *index = hash_map_get(theme->indexes, basedir);
+	if (index && index_is_stale(index)) {
+		sway_log(SWAY_DEBUG, "Icon theme '%s' changed in %s, reindexing",
+				theme->name, basedir);
+		hash_map_remove(theme->indexes, basedir);
+		destroy_index(index);
+		index = NULL;
+	}
+	if (!index) {
+		index = create_index(theme, basedir);
+		if (index && !hash_map_set(theme->indexes, basedir, index)) {
+			destroy_index(index);
+			index = NULL;
+		}
+	}
+	return index;
+}
+
 static void destroy_theme(struct icon_theme *theme) {
 	if (!theme) {
 		return;
 	}
+	if (theme->indexes) {
+		hash_map_for_each(theme->indexes, destroy_index_iterator, NULL);
+		hash_map_free(theme->indexes);
+	}
 	free(theme->name);
 	free(theme->comment);
 	list_free_items_and_destroy(theme->inherits);
@@ -308,7 +541,12 @@ static struct icon_theme *read_theme_file(char *basedir, char *theme_name) {
 
 	if (!error) {
 		theme->dir = strdup(theme_name);
-	} else {
+		theme->indexes = create_hash_map();
+		if (!theme->indexes) {
+			error = "out of memory";
+		}
+	}
+	if (error) {
 		char *last_group = groups->length > 0 ? groups->items[groups->length-1] : "n/a";
 		sway_log(SWAY_DEBUG, "Failed to load theme '%s' - parsing of file "
 				"'%s/%s/index.theme' failed on line %d (group '%s'): %s",
@@ -406,16 +644,6 @@ void finish_themes(list_t *themes, list_t *basedirs) {
 
 static char *find_icon_in_subdir(char *name, char *basedir, char *theme,
 		char *subdir) {
-	static const char *extensions[] = {
-#if HAVE_GDK_PIXBUF
-		"svg",
-#endif
-		"png",
-#if HAVE_GDK_PIXBUF
-		"xpm" // deprecated
-#endif
-	};
-
 	size_t path_len = snprintf(NULL, 0, "%s/%s/%s/%s.EXT", basedir, theme,
 			subdir, name) + 1;
 	char *path = malloc(path_len);
@@ -432,15 +660,6 @@ static char *find_icon_in_subdir(char *name, char *basedir, char *theme,
 	return NULL;
 }
 
-static bool theme_exists_in_basedir(char *theme, char *basedir) {
-	size_t path_len = snprintf(NULL, 0, "%s/%s", basedir, theme) + 1;
-	char *path = malloc(path_len);
-	snprintf(path, path_len, "%s/%s", basedir, theme);
-	bool ret = dir_exists(path);
-	free(path);
-	return ret;
-}
-
 static char *find_icon_with_theme(list_t *basedirs, list_t *themes, char *name,
 		int size, char *theme_name, int *min_size, int *max_size) {
 	struct icon_theme *theme = NULL;
@@ -453,59 +672,58 @@ static char *find_icon_with_theme(list_t *basedirs, list_t *themes, char *name,
 	}
 	if (!theme) return NULL;
 
-	char *icon = NULL;
+	list_t *candidates = create_list();
 	for (int i = 0; i < basedirs->length; ++i) {
-		if (!theme_exists_in_basedir(theme->dir, basedirs->items[i])) {
-			continue;
+		struct icon_theme_index *index = get_index(theme, basedirs->items[i]);
+		list_t *icons = index ? hash_map_get(index->icons, name) : NULL;
+		if (icons) {
+			list_cat(candidates, icons);
 		}
-		// search backwards to hopefully hit scalable/larger icons first
-		for (int j = theme->subdirs->length - 1; j >= 0; --j) {
-			struct icon_theme_subdir *subdir = theme->subdirs->items[j];
-			if (size >= subdir->min_size && size <= subdir->max_size) {
-				if ((icon = find_icon_in_subdir(name, basedirs->items[i],
-								theme->dir, subdir->name))) {
-					*min_size = subdir->min_size;
-					*max_size = subdir->max_size;
-					return icon;
-				}
-			}
+	}
+
+	struct icon_theme_icon *icon = NULL;
+	for (int i = 0; i < candidates->length; ++i) {
+		struct icon_theme_icon *candidate = candidates->items[i];
+		struct icon_theme_subdir *subdir = candidate->subdir;
+		if (size >= subdir->min_size && size <= subdir->max_size) {
+			icon = candidate;
+			break;
 		}
 	}
 
 	// inexact match
-	unsigned smallest_error = -1; // UINT_MAX
-	for (int i = 0; i < basedirs->length; ++i) {
-		if (!theme_exists_in_basedir(theme->dir, basedirs->items[i])) {
-			continue;
-		}
-		for (int j = theme->subdirs->length - 1; j >= 0; --j) {
-			struct icon_theme_subdir *subdir = theme->subdirs->items[j];
+	if (!icon) {
+		unsigned smallest_error = -1; // UINT_MAX
+		for (int i = 0; i < candidates->length; ++i) {
+			struct icon_theme_icon *candidate = candidates->items[i];
+			struct icon_theme_subdir *subdir = candidate->subdir;
 			unsigned error = (size > subdir->max_size ? size - subdir->max_size : 0)
 				+ (size < subdir->min_size ? subdir->min_size - size : 0);
 			if (error < smallest_error) {
-				char *test_icon = find_icon_in_subdir(name, basedirs->items[i],
-						theme->dir, subdir->name);
-				if (test_icon) {
-					icon = test_icon;
-					smallest_error = error;
-					*min_size = subdir->min_size;
-					*max_size = subdir->max_size;
-				}
+				icon = candidate;
+				smallest_error = error;
 			}
 		}
 	}
+	list_free(candidates);
+
+	if (icon) {
+		*min_size = icon->subdir->min_size;
+		*max_size = icon->subdir->max_size;
+		return strdup(icon->path);
+	}
 
-	if (!icon && theme->inherits) {
+	if (theme->inherits) {
 		for (int i = 0; i < theme->inherits->length; ++i) {
-			icon = find_icon_with_theme(basedirs, themes, name, size,
+			char *path = find_icon_with_theme(basedirs, themes, name, size,
 					theme->inherits->items[i], min_size, max_size);
-			if (icon) {
-				break;
+			if (path) {
+				return path;
 			}
 		}
 	}
 
-	return icon;
+	return NULL;
 }
 
 static char *find_fallback_icon(list_t *basedirs, char *name, int *min_size,
@@ -523,7 +741,6 @@ static char *find_fallback_icon(list_t *basedirs, char *name, int *min_size,
 
 char *find_icon(list_t *themes, list_t *basedirs, char *name, int size,
 		char *theme, int *min_size, int *max_size) {
-	// TODO https://specifications.freedesktop.org/icon-theme-spec/icon-theme-spec-latest.html#implementation_notes
 	char *icon = NULL;
 	if (theme) {
 		icon = find_icon_with_theme(basedirs, themes, name, size, theme,
@@ -0,0 +1,186 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include "swaybar/tray/icon_loader.h"
+#include "background-image.h"
+#include "log.h"
+
+struct icon_load {
+	struct wl_list link; // swaybar_icon_loader::pending, done
+	char *path;
+	cairo_surface_t *icon;
+};
+
+struct swaybar_icon_loader {
+	icon_loaded_func_t handler;
+	void *data;
+	int fd; // eventfd, signalled when loads are done
+
+	pthread_t thread;
+	// Everything below is protected by lock
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct wl_list pending; // icon_load::link
+	struct wl_list done; // icon_load::link
+	const char *loading; // path of the icon being loaded by the worker
+	bool quit;
+};
+
+static void destroy_icon_load(struct icon_load *load) {
+	wl_list_remove(&load->link);
+	cairo_surface_destroy(load->icon);
+	free(load->path);
+	free(load);
+}
+
+static void *icon_loader_run(void *data) {
+	struct swaybar_icon_loader *loader = data;
+	pthread_mutex_lock(&loader->lock);
+	while (!loader->quit) {
+		if (wl_list_empty(&loader->pending)) {
+			pthread_cond_wait(&loader->cond, &loader->lock);
+			continue;
+		}
+		struct icon_load *load =
+			wl_container_of(loader->pending.next, load, link);
+		wl_list_remove(&load->link);
+		loader->loading = load->path;
+		pthread_mutex_unlock(&loader->lock);
+
+		cairo_surface_t *icon = load_background_image(load->path);
+
+		pthread_mutex_lock(&loader->lock);
+		loader->loading = NULL;
+		load->icon = icon;
+		wl_list_insert(loader->done.prev, &load->link);
+		uint64_t one = 1;
+		if (write(loader->fd, &one, sizeof(one)) != sizeof(one)) {
+			sway_log_errno(SWAY_ERROR, "Failed to signal loaded icon");
+		}
+	}
+	pthread_mutex_unlock(&loader->lock);
+	return NULL;
+}
+
+struct swaybar_icon_loader *create_icon_loader(icon_loaded_func_t handler,
+		void *data) {
+	struct swaybar_icon_loader *loader =
+		calloc(1, sizeof(struct swaybar_icon_loader));
+	if (!loader) {
+		return NULL;
+	}
+	loader->handler = handler;
+	loader->data = data;
+	wl_list_init(&loader->pending);
+	wl_list_init(&loader->done);
+
+	loader->fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (loader->fd == -1) {
+		sway_log_errno(SWAY_ERROR, "Failed to create icon loader eventfd");
+		free(loader);
+		return NULL;
+	}
+	pthread_mutex_init(&loader->lock, NULL);
+	pthread_cond_init(&loader->cond, NULL);
+	int ret = pthread_create(&loader->thread, NULL, icon_loader_run, loader);
+	if (ret != 0) {
+		sway_log(SWAY_ERROR, "Failed to start icon loader thread: %s",
+				strerror(ret));
+		pthread_cond_destroy(&loader->cond);
+		pthread_mutex_destroy(&loader->lock);
+		close(loader->fd);
+		free(loader);
+		return NULL;
+	}
+	return loader;
+}
+
+void destroy_icon_loader(struct swaybar_icon_loader *loader) {
+	if (!loader) {
+		return;
+	}
+	pthread_mutex_lock(&loader->lock);
+	loader->quit = true;
+	pthread_cond_signal(&loader->cond);
+	pthread_mutex_unlock(&loader->lock);
+	pthread_join(loader->thread, NULL);
+
+	struct icon_load *load, *tmp;
+	wl_list_for_each_safe(load, tmp, &loader->pending, link) {
+		destroy_icon_load(load);
+	}
+	wl_list_for_each_safe(load, tmp, &loader->done, link) {
+		destroy_icon_load(load);
+	}
+	pthread_cond_destroy(&loader->cond);
+	pthread_mutex_destroy(&loader->lock);
+	close(loader->fd);
+	free(loader);
+}
+
+int icon_loader_get_fd(struct swaybar_icon_loader *loader) {
+	return loader->fd;
+}
+
+static bool is_queued(struct swaybar_icon_loader *loader, const char *path) {
+	if (loader->loading && strcmp(loader->loading, path) == 0) {
+		return true;
+	}
+	struct icon_load *load;
+	wl_list_for_each(load, &loader->pending, link) {
+		if (strcmp(load->path, path) == 0) {
+			return true;
+		}
+	}
+	wl_list_for_each(load, &loader->done, link) {
+		if (strcmp(load->path, path) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool icon_loader_request(struct swaybar_icon_loader *loader, const char *path) {
+	pthread_mutex_lock(&loader->lock);
+	if (is_queued(loader, path)) {
+		pthread_mutex_unlock(&loader->lock);
+		return true;
+	}
+	struct icon_load *load = calloc(1, sizeof(struct icon_load));
+	if (!load || !(load->path = strdup(path))) {
+		pthread_mutex_unlock(&loader->lock);
+		free(load);
+		return false;
+	}
+	wl_list_insert(loader->pending.prev, &load->link);
+	pthread_cond_signal(&loader->cond);
+	pthread_mutex_unlock(&loader->lock);
+	return true;
+}
+
+void icon_loader_in(int fd, short mask, void *data) {
+	struct swaybar_icon_loader *loader = data;
+	uint64_t count;
+	if (read(loader->fd, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+		sway_log_errno(SWAY_ERROR, "Failed to read icon loader eventfd");
+	}
+
+	struct wl_list done;
+	pthread_mutex_lock(&loader->lock);
+	wl_list_init(&done);
+	wl_list_insert_list(&done, &loader->done);
+	wl_list_init(&loader->done);
+	pthread_mutex_unlock(&loader->lock);
+
+	struct icon_load *load, *tmp;
+	wl_list_for_each_safe(load, tmp, &done, link) {
+		loader->handler(load->path, load->icon, loader->data);
+		destroy_icon_load(load);
+	}
+}
@@ -5,11 +5,13 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include "swaybar/bar.h"
 #include "swaybar/config.h"
 #include "swaybar/input.h"
 #include "swaybar/tray/host.h"
 #include "swaybar/tray/icon.h"
+#include "swaybar/tray/icon_loader.h"
 #include "swaybar/tray/item.h"
 #include "swaybar/tray/tray.h"
 #include "background-image.h"
@@ -26,9 +28,19 @@ static bool sni_ready(struct swaybar_sni *sni) {
 			sni->icon_name || sni->icon_pixmap);
 }
 
+static void clear_scaled_icons(struct swaybar_sni *sni) {
+	for (int i = 0; i < sni->scaled_icons->length; ++i) {
+		struct swaybar_sni_scaled_icon *scaled = sni->scaled_icons->items[i];
+		cairo_surface_destroy(scaled->surface);
+		free(scaled);
+	}
+	sni->scaled_icons->length = 0;
+}
+
 static void set_sni_dirty(struct swaybar_sni *sni) {
 	if (sni_ready(sni)) {
 		sni->target_size = sni->min_size = sni->max_size = 0; // invalidate previous icon
+		clear_scaled_icons(sni);
 		set_bar_dirty(sni->tray->bar);
 	}
 }
@@ -271,6 +283,7 @@ struct swaybar_sni *create_sni(char *id, struct swaybar_tray *tray) {
 		return NULL;
 	}
 	sni->tray = tray;
+	sni->scaled_icons = create_list();
 	wl_list_init(&sni->slots);
 	sni->watcher_id = strdup(id);
 	char *path_ptr = strchr(id, '/');
@@ -308,6 +321,10 @@ void destroy_sni(struct swaybar_sni *sni) {
 	}
 
 	cairo_surface_destroy(sni->icon);
+	free(sni->icon_path);
+	free(sni->pending_icon_path);
+	clear_scaled_icons(sni);
+	list_free(sni->scaled_icons);
 	free(sni->watcher_id);
 	free(sni->service);
 	free(sni->path);
@@ -405,6 +422,59 @@ static enum hotspot_event_handling icon_hotspot_callback(
 	return HOTSPOT_PROCESS;
 }
 
+bool sni_icon_loaded(struct swaybar_sni *sni, const char *path,
+		cairo_surface_t *icon) {
+	if (!sni->pending_icon_path || strcmp(sni->pending_icon_path, path) != 0) {
+		return false;
+	}
+	cairo_surface_destroy(sni->icon);
+	clear_scaled_icons(sni);
+	sni->icon = icon ? cairo_surface_reference(icon) : NULL;
+	free(sni->icon_path);
+	sni->icon_path = sni->pending_icon_path;
+	sni->pending_icon_path = NULL;
+	sni->icon_mtime = sni->pending_icon_mtime;
+	return true;
+}
+
+/**
+ * Replaces the icon with the one at icon_path, taking ownership of the path.
+ * The file is decoded by the tray's icon loader if there is one, and the
+ * current icon is kept until it is done.
+ */
+static void load_sni_icon(struct swaybar_sni *sni, char *icon_path) {
+	if (sni->pending_icon_path &&
+			strcmp(sni->pending_icon_path, icon_path) == 0) {
+		free(icon_path);
+		return;
+	}
+	free(sni->pending_icon_path);
+	sni->pending_icon_path = NULL;
+
+	// Applications may rewrite the same file for a new icon, so only skip
+	// the reload if the file hasn't been modified since it was loaded
+	struct stat sb;
+	struct timespec mtime = {0};
+	if (stat(icon_path, &sb) == 0) {
+		mtime = sb.st_mtim;
+	}
+	if (sni->icon && sni->icon_path && strcmp(sni->icon_path, icon_path) == 0 &&
+			mtime.tv_sec == sni->icon_mtime.tv_sec &&
+			mtime.tv_nsec == sni->icon_mtime.tv_nsec) {
+		free(icon_path);
+		return;
+	}
+
+	sni->pending_icon_path = icon_path;
+	sni->pending_icon_mtime = mtime;
+	struct swaybar_icon_loader *loader = sni->tray->icon_loader;
+	if (!loader || !icon_loader_request(loader, icon_path)) {
+		cairo_surface_t *icon = load_background_image(icon_path);
+		sni_icon_loaded(sni, icon_path, icon);
+		cairo_surface_destroy(icon);
+	}
+}
+
 static void reload_sni(struct swaybar_sni *sni, char *icon_theme,
 		int target_size) {
 	char *icon_name = sni->status[0] == 'N' ?
@@ -420,9 +490,7 @@ static void reload_sni(struct swaybar_sni *sni, char *icon_theme,
 				&sni->min_size, &sni->max_size);
 		list_free(icon_search_paths);
 		if (icon_path) {
-			cairo_surface_destroy(sni->icon);
-			sni->icon = load_background_image(icon_path);
-			free(icon_path);
+			load_sni_icon(sni, icon_path);
 			return;
 		}
 	}
@@ -440,25 +508,33 @@ static void reload_sni(struct swaybar_sni *sni, char *icon_theme,
 				min_error = e;
 			}
 		}
+		free(sni->pending_icon_path);
+		sni->pending_icon_path = NULL;
+		free(sni->icon_path);
+		sni->icon_path = NULL;
 		cairo_surface_destroy(sni->icon);
+		clear_scaled_icons(sni);
 		sni->icon = cairo_image_surface_create_for_data(pixmap->pixels,
 				CAIRO_FORMAT_ARGB32, pixmap->size, pixmap->size,
 				cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, pixmap->size));
 	}
 }
 
-uint32_t render_sni(cairo_t *cairo, struct swaybar_output *output, double *x,
-		struct swaybar_sni *sni) {
-	uint32_t height = output->height * output->scale;
-	int padding = output->bar->config->tray_padding;
-	int target_size = height - 2*padding;
-	if (target_size != sni->target_size && sni_ready(sni)) {
-		// check if another icon should be loaded
-		if (target_size < sni->min_size || target_size > sni->max_size) {
-			reload_sni(sni, output->bar->config->icon_theme, target_size);
-		}
+// Bars on outputs with different heights or scales render the icon at
+// different sizes, keep a few of them around
+#define MAX_SCALED_ICONS 4
 
-		sni->target_size = target_size;
+/**
+ * Returns sni->icon scaled for target_size, or a placeholder if there is no
+ * icon. The result is cached until the icon changes.
+ */
+static struct swaybar_sni_scaled_icon *get_scaled_icon(struct swaybar_sni *sni,
+		int target_size) {
+	for (int i = 0; i < sni->scaled_icons->length; ++i) {
+		struct swaybar_sni_scaled_icon *scaled = sni->scaled_icons->items[i];
+		if (scaled->target_size == target_size) {
+			return scaled;
+		}
 	}
 
 	int icon_size;
@@ -488,6 +564,46 @@ uint32_t render_sni(cairo_t *cairo, struct swaybar_output *output, double *x,
 		cairo_destroy(cairo_icon);
 	}
 
+	struct swaybar_sni_scaled_icon *scaled =
+		calloc(1, sizeof(struct swaybar_sni_scaled_icon));
+	if (!scaled) {
+		cairo_surface_destroy(icon);
+		return NULL;
+	}
+	scaled->target_size = target_size;
+	scaled->icon_size = icon_size;
+	scaled->surface = icon;
+	if (sni->scaled_icons->length == MAX_SCALED_ICONS) {
+		struct swaybar_sni_scaled_icon *oldest = sni->scaled_icons->items[0];
+		cairo_surface_destroy(oldest->surface);
+		free(oldest);
+		list_del(sni->scaled_icons, 0);
+	}
+	list_add(sni->scaled_icons, scaled);
+	return scaled;
+}
+
+uint32_t render_sni(cairo_t *cairo, struct swaybar_output *output, double *x,
+		struct swaybar_sni *sni) {
+	uint32_t height = output->height * output->scale;
+	int padding = output->bar->config->tray_padding;
+	int target_size = height - 2*padding;
+	if (target_size != sni->target_size && sni_ready(sni)) {
+		// check if another icon should be loaded
+		if (target_size < sni->min_size || target_size > sni->max_size) {
+			reload_sni(sni, output->bar->config->icon_theme, target_size);
+		}
+
+		sni->target_size = target_size;
+	}
+
+	struct swaybar_sni_scaled_icon *scaled = get_scaled_icon(sni, target_size);
+	if (!scaled) {
+		return 0;
+	}
+	int icon_size = scaled->icon_size;
+	cairo_surface_t *icon = scaled->surface;
+
 	int padded_size = icon_size + 2*padding;
 	*x -= padded_size;
 	int y = floor((height - padded_size) / 2.0);
@@ -499,8 +615,6 @@ uint32_t render_sni(cairo_t *cairo, struct swaybar_output *output, double *x,
 	cairo_fill(cairo);
 	cairo_set_operator(cairo, op);
 
-	cairo_surface_destroy(icon);
-
 	struct swaybar_hotspot *hotspot = calloc(1, sizeof(struct swaybar_hotspot));
 	hotspot->x = *x;
 	hotspot->y = 0;
@@ -1,16 +1,19 @@
 #include <cairo.h>
+#include <poll.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "swaybar/config.h"
 #include "swaybar/bar.h"
 #include "swaybar/tray/icon.h"
+#include "swaybar/tray/icon_loader.h"
 #include "swaybar/tray/host.h"
 #include "swaybar/tray/item.h"
 #include "swaybar/tray/tray.h"
 #include "swaybar/tray/watcher.h"
 #include "list.h"
 #include "log.h"
+#include "loop.h"
 
 static int handle_lost_watcher(sd_bus_message *msg,
 		void *data, sd_bus_error *error) {
@@ -33,6 +36,18 @@ static int handle_lost_watcher(sd_bus_message *msg,
 	return 0;
 }
 
+static void handle_icon_loaded(const char *path, cairo_surface_t *icon,
+		void *data) {
+	struct swaybar_tray *tray = data;
+	bool dirty = false;
+	for (int i = 0; i < tray->items->length; ++i) {
+		dirty |= sni_icon_loaded(tray->items->items[i], path, icon);
+	}
+	if (dirty) {
+		set_bar_dirty(tray->bar);
+	}
+}
+
 struct swaybar_tray *create_tray(struct swaybar *bar) {
 	sway_log(SWAY_DEBUG, "Initializing tray");
 
@@ -69,6 +84,11 @@ struct swaybar_tray *create_tray(struct swaybar *bar) {
 
 	init_themes(&tray->themes, &tray->basedirs);
 
+	tray->icon_loader = create_icon_loader(handle_icon_loaded, tray);
+	if (!tray->icon_loader) {
+		sway_log(SWAY_INFO, "Tray icons will be loaded synchronously");
+	}
+
 	return tray;
 }
 
@@ -76,6 +96,8 @@ void destroy_tray(struct swaybar_tray *tray) {
 	if (!tray) {
 		return;
 	}
+	// Stop the worker before the items and themes it might be loading for
+	destroy_icon_loader(tray->icon_loader);
 	finish_host(&tray->host_xdg);
 	finish_host(&tray->host_kde);
 	for (int i = 0; i < tray->items->length; ++i) {
@@ -89,6 +111,23 @@ void destroy_tray(struct swaybar_tray *tray) {
 	free(tray);
 }
 
+void tray_add_fds(struct swaybar_tray *tray) {
+	struct loop *loop = tray->bar->eventloop;
+	loop_add_fd(loop, tray->fd, POLLIN, tray_in, tray->bus);
+	if (tray->icon_loader) {
+		loop_add_fd(loop, icon_loader_get_fd(tray->icon_loader), POLLIN,
+				icon_loader_in, tray->icon_loader);
+	}
+}
+
+void tray_remove_fds(struct swaybar_tray *tray) {
+	struct loop *loop = tray->bar->eventloop;
+	loop_remove_fd(loop, tray->fd);
+	if (tray->icon_loader) {
+		loop_remove_fd(loop, icon_loader_get_fd(tray->icon_loader));
+	}
+}
+
 void tray_in(int fd, short mask, void *data) {
 	sd_bus *bus = data;
 	int ret;
@@ -8,11 +8,15 @@
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 #include <json.h>
 #include "stringop.h"
 #include "ipc-client.h"
+#include "list.h"
 #include "log.h"
 
 void sway_terminate(int exit_code) {
@@ -334,16 +338,227 @@ static void pretty_print(int type, json_object *resp) {
 	}
 }
 
+/*
+ * A minimal JSON scanner for --filter, which finds values in event payloads
+ * without building a json-c object for each event. It relies on sway sending
+ * valid JSON and returns NULL where it doesn't understand the input.
+ */
+static const char *json_skip_ws(const char *p) {
+	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+		++p;
+	}
+	return p;
+}
+
+// p points to the opening quote, returns the position after the closing one
+static const char *json_skip_string(const char *p) {
+	for (++p; *p && *p != '"'; ++p) {
+		if (*p == '\\' && p[1]) {
+			++p;
+		}
+	}
+	return *p ? p + 1 : NULL;
+}
+
+static const char *json_skip_value(const char *p) {
+	p = json_skip_ws(p);
+	if (*p == '"') {
+		return json_skip_string(p);
+	} else if (*p == '{' || *p == '[') {
+		int depth = 0;
+		while (*p) {
+			if (*p == '"') {
+				if (!(p = json_skip_string(p))) {
+					return NULL;
+				}
+				continue;
+			}
+			if (*p == '{' || *p == '[') {
+				++depth;
+			} else if ((*p == '}' || *p == ']') && --depth == 0) {
+				return p + 1;
+			}
+			++p;
+		}
+		return NULL;
+	}
+	// number, true, false or null
+	const char *start = p;
+	while (*p && !strchr(",}] \t\n\r", *p)) {
+		++p;
+	}
+	return p == start ? NULL : p;
+}
+
+// Returns the value of the member key of the object at p, and its end in end
+static const char *json_find_member(const char *p, const char *key,
+		size_t key_len, const char **end) {
+	p = json_skip_ws(p);
+	if (*p != '{') {
+		return NULL;
+	}
+	p = json_skip_ws(p + 1);
+	while (*p == '"') {
+		const char *name = p + 1;
+		const char *name_end = json_skip_string(p);
+		if (!name_end) {
+			return NULL;
+		}
+		bool match = (size_t)(name_end - 1 - name) == key_len &&
+			strncmp(name, key, key_len) == 0;
+		p = json_skip_ws(name_end);
+		if (*p != ':') {
+			return NULL;
+		}
+		const char *value = json_skip_ws(p + 1);
+		const char *value_end = json_skip_value(value);
+		if (!value_end) {
+			return NULL;
+		}
+		if (match) {
+			*end = value_end;
+			return value;
+		}
+		p = json_skip_ws(value_end);
+		if (*p != ',') {
+			return NULL;
+		}
+		p = json_skip_ws(p + 1);
+	}
+	return NULL;
+}
+
+// Finds the value at a path of dot separated keys, such as "current.name"
+static const char *json_select(const char *json, const char *path,
+		const char **end) {
+	const char *value = json;
+	*end = NULL;
+	while (*path) {
+		size_t len = strcspn(path, ".");
+		if (!(value = json_find_member(value, path, len, end))) {
+			return NULL;
+		}
+		path += len;
+		if (*path == '.') {
+			++path;
+		}
+	}
+	if (!*end) {
+		value = json_skip_ws(value);
+		*end = json_skip_value(value);
+	}
+	return *end ? value : NULL;
+}
+
+/*
+ * Output of the event stream in raw and filtered mode. The iovecs point into
+ * the IPC connection's buffer, so they have to be flushed before it reads
+ * again.
+ */
+struct event_output {
+	struct iovec iov[IOV_MAX];
+	int count;
+};
+
+static bool event_output_flush(struct event_output *out) {
+	struct iovec *vec = out->iov;
+	int count = out->count;
+	out->count = 0;
+	while (count > 0) {
+		ssize_t written = writev(STDOUT_FILENO, vec, count);
+		if (written == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		while (count > 0 && (size_t)written >= vec->iov_len) {
+			written -= vec->iov_len;
+			++vec;
+			--count;
+		}
+		if (count > 0) {
+			vec->iov_base = (char *)vec->iov_base + written;
+			vec->iov_len -= written;
+		}
+	}
+	return true;
+}
+
+static bool event_output_add(struct event_output *out, const char *data,
+		size_t len) {
+	if (out->count == IOV_MAX && !event_output_flush(out)) {
+		return false;
+	}
+	out->iov[out->count].iov_base = (void *)data;
+	out->iov[out->count].iov_len = len;
+	out->count++;
+	return true;
+}
+
+static bool event_output_add_event(struct event_output *out,
+		struct ipc_message *msg, list_t *filter) {
+	if (!filter) {
+		return event_output_add(out, msg->payload, msg->size) &&
+			event_output_add(out, "\n", 1);
+	}
+	for (int i = 0; i < filter->length; ++i) {
+		const char *end;
+		const char *value = json_select(msg->payload, filter->items[i], &end);
+		if (i > 0 && !event_output_add(out, "\t", 1)) {
+			return false;
+		}
+		if (!(value ? event_output_add(out, value, end - value) :
+					event_output_add(out, "null", 4))) {
+			return false;
+		}
+	}
+	return event_output_add(out, "\n", 1);
+}
+
+/*
+ * Passes the payloads of events through, or the selected fields of them,
+ * without parsing them. All events which arrived together are written with a
+ * single writev.
+ */
+static void monitor_events_raw(struct ipc_connection *conn, bool monitor,
+		list_t *filter) {
+	struct event_output *out = calloc(1, sizeof(struct event_output));
+	if (!out) {
+		sway_abort("Unable to allocate output buffer");
+	}
+	fflush(stdout);
+	struct ipc_message event;
+	bool done = false;
+	while (!done) {
+		if (!ipc_connection_recv(conn, &event)) {
+			sway_abort("Unable to receive IPC response");
+		}
+		do {
+			if (!event_output_add_event(out, &event, filter)) {
+				sway_abort("Unable to write events");
+			}
+			done = !monitor;
+		} while (!done && ipc_connection_next(conn, &event));
+		if (!event_output_flush(out)) {
+			sway_abort("Unable to write events");
+		}
+	}
+	free(out);
+}
+
 int main(int argc, char **argv) {
 	static bool quiet = false;
 	static bool raw = false;
 	static bool monitor = false;
+	list_t *filter = NULL;
 	char *socket_path = NULL;
 	char *cmdtype = NULL;
 
 	sway_log_init(SWAY_INFO, NULL);
 
 	static struct option long_options[] = {
+		{"filter", required_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
 		{"monitor", no_argument, NULL, 'm'},
 		{"pretty", no_argument, NULL, 'p'},
@@ -358,6 +573,8 @@ int main(int argc, char **argv) {
 	const char *usage =
 		"Usage: swaymsg [options] [message]\n"
 		"\n"
+		"  -f, --filter <fields>  Only print these fields of events\n"
+		"                         (-t SUBSCRIBE only)\n"
 		"  -h, --help             Show help message and quit.\n"
 		"  -m, --monitor          Monitor until killed (-t SUBSCRIBE only)\n"
 		"  -p, --pretty           Use pretty output even when not using a tty\n"
@@ -372,11 +589,17 @@ int main(int argc, char **argv) {
 	int c;
 	while (1) {
 		int option_index = 0;
-		c = getopt_long(argc, argv, "hmpqrs:t:v", long_options, &option_index);
+		c = getopt_long(argc, argv, "f:hmpqrs:t:v", long_options, &option_index);
 		if (c == -1) {
 			break;
 		}
 		switch (c) {
+		case 'f': // Filter
+			if (filter) {
+				list_free_items_and_destroy(filter);
+			}
+			filter = split_string(optarg, ",");
+			break;
 		case 'm': // Monitor
 			monitor = true;
 			break;
@@ -464,6 +687,13 @@ int main(int argc, char **argv) {
 		free(socket_path);
 		return 1;
 	}
+	if (filter && type != IPC_SUBSCRIBE) {
+		if (!quiet) {
+			sway_log(SWAY_ERROR, "Filter can only be used with -t SUBSCRIBE");
+		}
+		free(socket_path);
+		return 1;
+	}
 
 	char *command = NULL;
 	if (optind < argc) {
@@ -511,38 +741,44 @@ int main(int argc, char **argv) {
 		timeout.tv_usec = 0;
 		ipc_set_recv_timeout(socketfd, timeout);
 
-		do {
-			struct ipc_response *reply = ipc_recv_response(socketfd);
-			if (!reply) {
-				break;
-			}
-
-			json_object *obj = json_tokener_parse(reply->payload);
-			if (obj == NULL) {
-				if (!quiet) {
-					fprintf(stderr, "ERROR: Could not parse json response from"
-							" ipc. This is a bug in sway.");
-					ret = 1;
+		struct ipc_connection *conn = ipc_connection_create(socketfd);
+		if (!conn) {
+			sway_abort("Unable to allocate IPC conn");
+		}
+		if (!quiet && (raw || filter)) {
+			monitor_events_raw(conn, monitor, filter);
+		} else {
+			struct ipc_message reply;
+			do {
+				if (!ipc_connection_recv(conn, &reply)) {
+					sway_abort("Unable to receive IPC response");
 				}
-				break;
-			} else if (quiet) {
-				json_object_put(obj);
-			} else {
-				if (raw) {
-					printf("%s\n", json_object_to_json_string(obj));
+
+				json_object *obj = json_tokener_parse(reply.payload);
+				if (obj == NULL) {
+					if (!quiet) {
+						fprintf(stderr, "ERROR: Could not parse json response from"
+								" ipc. This is a bug in sway.");
+						ret = 1;
+					}
+					break;
+				} else if (quiet) {
+					json_object_put(obj);
 				} else {
 					printf("%s\n", json_object_to_json_string_ext(obj,
 						JSON_C_TO_STRING_PRETTY | JSON_C_TO_STRING_SPACED));
+					fflush(stdout);
+					json_object_put(obj);
 				}
-				fflush(stdout);
-				json_object_put(obj);
-			}
-
-			free_ipc_response(reply);
-		} while (monitor);
+			} while (monitor);
+		}
+		ipc_connection_destroy(conn);
 	}
 
 	close(socketfd);
 	free(socket_path);
+	if (filter) {
+		list_free_items_and_destroy(filter);
+	}
 	return ret;
 }